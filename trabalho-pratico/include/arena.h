@@ -0,0 +1,35 @@
+/**
+ * @file arena.h
+ * @brief Header file for the arena (bump pointer) allocator of the catalog records.
+ *
+ * The records of a dataset are allocated one after the other in big blocks, that are all freed
+ * at once when the catalog is freed (the records are never freed one by one).
+*/
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_BLOCK_SIZE (1 << 20) // size of each block of an arena (1 MiB), bigger allocations get their own block
+#define ARENA_ALIGNMENT 8 // every allocation is aligned to 8 bytes (the records have pointers and 64 bit dates)
+
+typedef struct arena_block {
+    struct arena_block *next; // previous block of the arena (the blocks are a stack)
+    size_t size; // usable size of the block
+    size_t used; // bytes already allocated in the block
+} ARENA_BLOCK;
+
+typedef struct arena {
+    ARENA_BLOCK *blocks; // the block being filled (and, through next, the previous ones)
+    size_t allocations; // number of allocations (records, arrays) made in the arena
+    size_t blocks_count; // number of blocks (allocations made to the system)
+    size_t bytes; // bytes allocated in the arena
+} ARENA;
+
+ARENA *new_arena(void);
+void *arena_alloc(ARENA *arena, size_t size);
+void *arena_copy(ARENA *arena, const void *data, size_t size);
+void arena_merge(ARENA *destination, ARENA *source);
+void free_arena(ARENA *arena);
+
+#endif
@@ -6,11 +6,11 @@
 #define BATCHMODE_H
 
 #include "catalog.h"
+#include "resultBuffer.h"
 
 #define MAX_ARGS 20
-#define MAX_COMMAND_SIZE 256 // Tamanho máximo de um comando
 
 void batchMode(char *inputFile, char *outputDirectory, CATALOG *c, int runninTests);
-void execute_command(int line, char* command, char* outputDirectory, CATALOG *c, int runninTests);
+void execute_command(int line, char* command, char* outputDirectory, CATALOG *c, int runninTests, RESULT_BUFFER *result);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,10 @@
+/**
+ * @file benchmark.h
+ * @brief Header file for the microbenchmarks (run with: programa-testes --benchmark <caminho para o dataset com os CSVs>).
+*/
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+void run_benchmarks(const char *datasetDir);
+
+#endif
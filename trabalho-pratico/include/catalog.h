@@ -5,6 +5,11 @@
 #ifndef CATALOG_H
 #define CATALOG_H
 
+#include "mappedFile.h"
+#include "arena.h"
+#include "stringPool.h"
+#include "structs.h"
+
 #include <glib.h>
 
 typedef struct catalog {
@@ -12,10 +17,26 @@ typedef struct catalog {
 	GHashTable *passengers;
 	GHashTable *flights;
     GHashTable *reservations;
+    GHashTable *user_reservations; // user_id -> USER_RESERVATIONS (index of the reservations by user)
+    GHashTable *hotel_reservations; // interned hotel_id -> HOTEL_RESERVATIONS (index of the reservations by hotel, sorted by begin_date)
+    GHashTable *origin_flights; // upper case origin -> AIRPORT_FLIGHTS (index of the flights by origin, sorted by schedule_departure_date)
+    AIRPORT_PASSENGERS *airport_passengers; // the passengers of each airport in each year (query 6)
+    METRICS_CUBE *metrics; // the metrics by year, month and day (query 10)
+    USER_NAMES *user_names; // the active users sorted by name (index of query 9)
+    USER_FLIGHTS *user_flights; // the flights of each user (index of the passengers by user)
+    GPtrArray *sources; // mapped dataset files the records point into
+    GPtrArray *arenas; // arenas where the records are allocated
+    STRING_POOL *strings; // interned values of the low cardinality columns (airports, airlines, hotels, ...)
 } CATALOG;
 
 void print_catalog(CATALOG *c);
 void free_catalog(CATALOG *c);
 CATALOG *newCatalog(GHashTable *users, GHashTable *passengers, GHashTable *flights, GHashTable *reservations);
+void add_catalog_source(CATALOG *c, MAPPED_FILE *file);
+void add_catalog_arena(CATALOG *c, ARENA *arena);
+USER_RESERVATIONS *get_catalog_user_reservations(CATALOG *c, const char *user_id);
+HOTEL_RESERVATIONS *get_catalog_hotel_reservations(CATALOG *c, const char *hotel_id);
+AIRPORT_FLIGHTS *get_catalog_origin_flights(CATALOG *c, const char *airport);
+FLIGHT **get_catalog_user_flights(CATALOG *c, const char *user_id, int *count);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,22 @@
+/**
+ * @file fieldScanner.h
+ * @brief Header file for the CSV field scanner.
+ *
+ * The scanner finds the ';' and '\n' of a record a block of bytes at a time (AVX2 or SSE2 when the
+ * processor supports them, with a scalar fallback) and splits the record in place, without allocating.
+*/
+#ifndef FIELDSCANNER_H
+#define FIELDSCANNER_H
+
+typedef enum field_scanner {
+    SCANNER_SCALAR,
+    SCANNER_SSE2,
+    SCANNER_AVX2
+} FIELD_SCANNER;
+
+FIELD_SCANNER best_field_scanner(void);
+const char *field_scanner_name(FIELD_SCANNER scanner);
+char *scan_fields_using(FIELD_SCANNER scanner, char *line, char *end, char **fields, int max_fields, int *fields_count);
+char *scan_fields(char *line, char *end, char **fields, int max_fields, int *fields_count);
+
+#endif
@@ -31,8 +31,8 @@ void showTitleScreen();
 void askDatasetPath();
 void showMenu();
 char *askForQArgs(int query_id);
-void print_result(GList *result, int page_size, int *pages);
-void showQResult(GList *result);
+void print_result(RESULT_BUFFER *result, int page_size, int *pages);
+void showQResult(RESULT_BUFFER *result);
 void execute_query(CATALOG *c, int query);
 void execute_main_app(CATALOG *c);
 void initialize_app_status();
@@ -0,0 +1,26 @@
+/**
+ * @file lineReader.h
+ * @brief Header file for the line reader (lines of any length read from a stream, like the commands file).
+ *
+ * The lines are read with fgets into a buffer that is reused between lines and only grows
+ * when a line does not fit (so a normal line costs a single fgets, without any allocation).
+*/
+#ifndef LINEREADER_H
+#define LINEREADER_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define LINE_READER_INITIAL_SIZE 1024 // initial size of the buffer of a line reader (doubled for each longer line)
+
+typedef struct line_reader {
+    FILE *file;
+    char *buffer; // the last line read
+    size_t capacity; // size of the buffer
+} LINE_READER;
+
+LINE_READER *new_line_reader(FILE *file);
+char *read_line(LINE_READER *reader, size_t *length);
+void free_line_reader(LINE_READER *reader);
+
+#endif
@@ -0,0 +1,33 @@
+/**
+ * @file loader.h
+ * @brief Header file for the dataset loader.
+ *
+ * The loader runs the parsers in parallel, respecting the dependencies between the datasets:
+ * users and flights are parsed concurrently, reservations starts as soon as the users are ready
+ * and passengers as soon as both users and flights are ready.
+*/
+#ifndef LOADER_H
+#define LOADER_H
+
+#include "catalog.h"
+
+#include <glib.h>
+
+typedef struct load_stage_time {
+    gint64 start; // wall clock (monotonic) time when the stage started, in microseconds
+    gint64 end; // wall clock (monotonic) time when the stage ended, in microseconds
+} LOAD_STAGE_TIME;
+
+typedef struct load_times {
+    LOAD_STAGE_TIME users;
+    LOAD_STAGE_TIME reservations;
+    LOAD_STAGE_TIME flights;
+    LOAD_STAGE_TIME passengers;
+    LOAD_STAGE_TIME total;
+} LOAD_TIMES;
+
+void load_catalog(CATALOG *c, const char *datasetDir, const char *outputDir, LOAD_TIMES *times);
+double load_stage_seconds(LOAD_STAGE_TIME stage);
+void print_load_times(LOAD_TIMES *times);
+
+#endif
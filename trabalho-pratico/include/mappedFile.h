@@ -0,0 +1,38 @@
+/**
+ * @file mappedFile.h
+ * @brief Header file for the memory-mapped dataset files.
+ *
+ * The dataset files are mapped (copy-on-write) and tokenized in place, so the parsed records
+ * can keep their fields as slices of the mapped file instead of heap copies.
+*/
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <stddef.h>
+
+typedef struct mapped_file {
+    char *data; // file contents, always followed by a '\0'
+    size_t size; // size of the file in bytes
+    size_t map_size; // size of the mapping (the file plus, at least, the trailing '\0')
+    char *cursor; // next byte to be read by next_mapped_line
+} MAPPED_FILE;
+
+#define MAX_MAPPED_CHUNKS 8 // maximum number of chunks (parser workers) a file is split into
+#define MIN_MAPPED_CHUNK_SIZE (1 << 20) // files are only split in chunks of, at least, 1 MiB
+
+typedef struct mapped_chunk {
+    char *cursor; // next byte to be read by next_chunk_record
+    char *end; // end of the chunk (first byte after its last '\n')
+} MAPPED_CHUNK;
+
+MAPPED_FILE *open_mapped_dataset(const char *datasetDir, const char *datasetName);
+MAPPED_FILE *open_mapped_file(const char *path);
+char *next_mapped_line(MAPPED_FILE *file);
+char *next_mapped_record(MAPPED_FILE *file, char **fields, int max_fields, int *fields_count);
+void restore_line(char **fields, int max_fields, int fields_count);
+int split_mapped_chunks(MAPPED_FILE *file, MAPPED_CHUNK *chunks);
+char *next_chunk_record(MAPPED_CHUNK *chunk, char **fields, int max_fields, int *fields_count);
+void run_chunk_workers(void *(*worker)(void *), void *tasks, size_t task_size, int tasks_count);
+void close_mapped_dataset(MAPPED_FILE *file);
+
+#endif
@@ -5,11 +5,16 @@
 #ifndef FLIGHTS_H
 #define FLIGHTS_H
 
+#include "mappedFile.h"
+#include "arena.h"
+#include "stringPool.h"
+
 #include <glib.h>
 
-void free_flight(gpointer data);
 void print_hash_flight(gpointer key, gpointer value, gpointer data);
-GHashTable* parse_flights(const char* datasetDir, const char* outputDir);
+GHashTable* parse_flights(const char* datasetDir, const char* outputDir, ARENA *arena, STRING_POOL *strings, MAPPED_FILE **source);
+void remap_flights_strings(GHashTable *flights, GHashTable *remap);
+GHashTable *index_origin_flights(GHashTable *flights, ARENA *arena);
 void free_flights(GHashTable* users);
 int isFlightValid(GHashTable *flights, char* flight_id);
 
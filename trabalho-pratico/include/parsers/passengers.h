@@ -5,11 +5,16 @@
 #ifndef PASSENGERS_H
 #define PASSENGERS_H
 
+#include "mappedFile.h"
+#include "arena.h"
+#include "structs.h"
+
 #include <glib.h>
 
-void free_flight_seats(gpointer data);
 void print_hash_passenger(gpointer key, gpointer value, gpointer data);
-GHashTable* parse_passengers(const char* datasetDir, const char* outputDir, GHashTable* users, GHashTable* flights);
+GHashTable* parse_passengers(const char* datasetDir, const char* outputDir, GHashTable* users, GHashTable* flights, ARENA *arena, USER_FLIGHTS **user_flights, MAPPED_FILE **source);
+USER_FLIGHTS *index_user_flights(GHashTable *passengers, GHashTable *flights, ARENA *arena);
+AIRPORT_PASSENGERS *index_airport_passengers(GHashTable *flights, GHashTable *passengers, ARENA *arena);
 void free_passengers(GHashTable* passengers);
 int get_flight_passengers(GHashTable *passengers, char* flight_id);
 
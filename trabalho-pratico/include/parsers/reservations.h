@@ -5,11 +5,19 @@
 #ifndef RESERVATIONS_H
 #define RESERVATIONS_H
 
+#include "mappedFile.h"
+#include "arena.h"
+#include "stringPool.h"
+#include "structs.h"
+
 #include <glib.h>
 
-void free_reservation(gpointer data);
 void print_hash_reservation(gpointer key, gpointer value, gpointer data);
-GHashTable* parse_reservations(const char* datasetDir, const char* outputDir, GHashTable* users);
+GHashTable* parse_reservations(const char* datasetDir, const char* outputDir, GHashTable* users, ARENA *arena, STRING_POOL *strings, GHashTable **user_reservations, MAPPED_FILE **source);
+GHashTable *index_user_reservations(GHashTable *reservations, ARENA *arena);
+GHashTable *index_hotel_reservations(GHashTable *reservations, ARENA *arena);
+long long hotel_revenue_before(HOTEL_REVENUE *revenue, int day);
+void remap_reservations_strings(GHashTable *reservations, GHashTable *remap);
 void free_reservations(GHashTable* users);
 
 #endif
\ No newline at end of file
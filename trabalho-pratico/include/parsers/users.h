@@ -5,11 +5,17 @@
 #ifndef USERS_H
 #define USERS_H
 
+#include "mappedFile.h"
+#include "arena.h"
+#include "stringPool.h"
+#include "structs.h"
+
 #include <glib.h>
 
-void free_user(gpointer data);
 void print_hash_user(gpointer key, gpointer value, gpointer data);
-GHashTable* parse_users(const char* datasetDir, const char* outputDir);
+GHashTable* parse_users(const char* datasetDir, const char* outputDir, ARENA *arena, STRING_POOL *strings, MAPPED_FILE **source);
+void remap_users_strings(GHashTable *users, GHashTable *remap);
+USER_NAMES *index_user_names(GHashTable *users, ARENA *arena);
 void free_users(GHashTable* users);
 int isValidUser(GHashTable *users, const char *user_id);
 
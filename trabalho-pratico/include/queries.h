@@ -6,20 +6,21 @@
 #define QUERIES_H
 
 #include "catalog.h"
+#include "resultBuffer.h"
 
 #define MAX_RES_SIZE 1024
 
 #include <glib.h>
 
 char* query_1(CATALOG *c, int format_flag, char **args, int args_size);
-void query_2(CATALOG *c, int format_flag, char **args, int args_size, GList **resList);
+void query_2(CATALOG *c, int format_flag, char **args, int args_size, RESULT_BUFFER *result);
 char* query_3(CATALOG *c, int format_flag, char **args, int args_size);
-void query_4(CATALOG *c, int format_flag, char **args, int args_size, GList **reservationsList);
-void query_5(CATALOG *c, int format_flag, char **args, int args_size, GList **resList);
-void query_6(CATALOG *c, int format_flag, char **args, int args_size, GList **resList);
-void query_7(CATALOG *c, int format_flag, char **args, int args_size, GList **resList);
+void query_4(CATALOG *c, int format_flag, char **args, int args_size, RESULT_BUFFER *result);
+void query_5(CATALOG *c, int format_flag, char **args, int args_size, RESULT_BUFFER *result);
+void query_6(CATALOG *c, int format_flag, char **args, int args_size, RESULT_BUFFER *result);
+void query_7(CATALOG *c, int format_flag, char **args, int args_size, RESULT_BUFFER *result);
 char* query_8(CATALOG *c, int format_flag, char **args, int args_size);
-void query_9(CATALOG *c, int format_flag, char **args, int args_size, GList **usersList);
-void query_10(CATALOG *c, int format_flag, char **args, int args_size, GList **resList);
+void query_9(CATALOG *c, int format_flag, char **args, int args_size, RESULT_BUFFER *result);
+void query_10(CATALOG *c, int format_flag, char **args, int args_size, RESULT_BUFFER *result);
 
 #endif
\ No newline at end of file
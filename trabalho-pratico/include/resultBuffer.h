@@ -0,0 +1,30 @@
+/**
+ * @file resultBuffer.h
+ * @brief Header file for the result buffers (the lines of the result of a query, in a single growable buffer).
+ *
+ * A line of a result is an element of the result (in the format F it takes more than one line of text). The lines
+ * are appended, in order, to the same buffer, so a result costs a few reallocations instead of an allocation
+ * (and a list node) per line, and it is written to a file with a single fwrite.
+*/
+#ifndef RESULTBUFFER_H
+#define RESULTBUFFER_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <glib.h>
+
+typedef struct result_buffer {
+    GString *text; // the lines, one after the other
+    GArray *lines; // offset (gsize) in text where each line starts
+} RESULT_BUFFER;
+
+RESULT_BUFFER *new_result_buffer(void);
+void result_buffer_append(RESULT_BUFFER *result, const char *line);
+void result_buffer_printf(RESULT_BUFFER *result, const char *format, ...);
+int result_buffer_size(RESULT_BUFFER *result);
+const char *result_buffer_line(RESULT_BUFFER *result, int index, gsize *length);
+void write_result_buffer(RESULT_BUFFER *result, FILE *file);
+void clear_result_buffer(RESULT_BUFFER *result);
+void free_result_buffer(RESULT_BUFFER *result);
+
+#endif
@@ -0,0 +1,42 @@
+/**
+ * @file snapshot.h
+ * @brief Header file for the catalog snapshots (a validated catalog saved to a binary file, to be loaded without parsing the CSVs).
+ *
+ * A snapshot has a header, the records of each dataset (the structs as they are in memory, with the strings
+ * replaced by offsets), the passengers of the flights and the strings. It is loaded by mapping the file and
+ * replacing the offsets by pointers in place (the mapping is copy-on-write, so the file is not changed).
+ * The records are saved as they are in memory, so a snapshot can only be loaded by the same build (@see SNAPSHOT_VERSION).
+*/
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "catalog.h"
+
+#include <glib.h>
+
+#define SNAPSHOT_MAGIC "LI3SNAP" // first bytes of a snapshot file (with the '\0')
+#define SNAPSHOT_VERSION 1 // increment when the records (structs.h) or the file layout change
+
+typedef struct snapshot_section {
+    guint64 offset; // offset of the section in the file
+    guint64 count; // number of elements of the section
+} SNAPSHOT_SECTION;
+
+typedef struct snapshot_header {
+    char magic[8]; // SNAPSHOT_MAGIC
+    guint32 version; // SNAPSHOT_VERSION
+    guint32 header_size; // sizeof(SNAPSHOT_HEADER)
+    guint32 record_sizes[4]; // sizeof of USER, FLIGHT, RESERVATION and FLIGHT_SEATS (the snapshot is only valid for the same layout)
+    SNAPSHOT_SECTION users; // USER records
+    SNAPSHOT_SECTION flights; // FLIGHT records
+    SNAPSHOT_SECTION reservations; // RESERVATION records
+    SNAPSHOT_SECTION flight_seats; // FLIGHT_SEATS records (their passengers are indexes in the passengers section)
+    SNAPSHOT_SECTION passengers; // user ids of the passengers of all the flights (as string offsets)
+    SNAPSHOT_SECTION strings; // the strings, each one followed by a '\0' (count is the size in bytes, offset 0 is NULL)
+} SNAPSHOT_HEADER;
+
+void save_snapshot(CATALOG *c, const char *path);
+int load_snapshot(CATALOG *c, const char *path);
+int is_snapshot_path(const char *path);
+
+#endif
@@ -5,18 +5,26 @@
 #ifndef STATISTICS_H
 #define STATISTICS_H
 
+#include "structs.h"
+#include "catalog.h"
+
 #include <glib.h>
 
-int calculate_nights(const char* begin_date, const char* end_date);
-int calculate_age(const char *birth_date);
-int count_number_flights(GHashTable *passengers, const char *user_id);
-char** get_user_flights(GHashTable *passengers, const char *user_id);
-int count_number_reservations(GHashTable *reservations, const char *user_id);
-char** get_user_reservations(GHashTable *reservations, const char *user_id);
-double calculate_total_spent(GHashTable *reservations, const char *user_id);
-double calculate_total_price(const char *price_per_night, int number_of_nights, int city_tax);
-int calculate_delay(const char *schedule_departure_date, const char *real_departure_date);
+int calculate_day_number(DATETIME date);
+int calculate_nights(DATETIME begin_date, DATETIME end_date);
+int calculate_age(DATETIME birth_date);
+int count_number_flights(CATALOG *c, const char *user_id);
+char** get_user_flights(CATALOG *c, const char *user_id);
+int count_number_reservations(CATALOG *c, const char *user_id);
+char** get_user_reservations(CATALOG *c, const char *user_id);
+double calculate_total_spent(CATALOG *c, const char *user_id);
+double calculate_total_price(int price_per_night, int number_of_nights, int city_tax);
+int calculate_delay(DATETIME schedule_departure_date, DATETIME real_departure_date);
+int get_flight_delay(FLIGHT *flight);
+int median_delay(int *delays, int delays_count);
+int percentile_delay(int *delays, int delays_count, int percentile);
 int date_comparator_wt(const char *date1, const char *date2);
 int date_comparator(const char *date1, const char *date2);
+METRICS_CUBE *build_metrics_cube(CATALOG *c, ARENA *arena);
 
 #endif
\ No newline at end of file
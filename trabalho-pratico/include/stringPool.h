@@ -0,0 +1,25 @@
+/**
+ * @file stringPool.h
+ * @brief Header file for the string pool (interning of the low cardinality columns, like airports, airlines and hotels).
+ *
+ * Every distinct value of an interned column is kept once (the first slice of the mapped file where it appears),
+ * so the records share the same pointer and two values are equal if and only if their pointers are equal.
+*/
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <glib.h>
+
+typedef struct string_pool {
+    GHashTable *strings; // value -> interned value (the same string, the first one interned)
+} STRING_POOL;
+
+STRING_POOL *new_string_pool(void);
+char *intern_string(STRING_POOL *pool, char *value);
+char *find_interned_string(STRING_POOL *pool, const char *value);
+GHashTable *merge_string_pools(STRING_POOL *destination, STRING_POOL *source);
+char *remap_interned_string(GHashTable *remap, char *value);
+guint string_pool_size(STRING_POOL *pool);
+void free_string_pool(STRING_POOL *pool);
+
+#endif
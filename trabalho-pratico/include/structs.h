@@ -5,39 +5,79 @@
 #ifndef STRUCTS_H
 #define STRUCTS_H
 
+#include <glib.h>
+
 #define MAX_LINE_SIZE 1024
 #define MAX_PATH_LENGTH 256
 
+/* Packed dates */
+// a date (and time) packed in an integer: year | month (4 bits) | day (5 bits) | hour (5 bits) | minute (6 bits) | second (6 bits)
+// the integer order is the chronological order, @see parseDate
+typedef unsigned long long DATETIME;
+
+#define DATE_INVALID 0
+#define DATE_ONLY 1
+#define DATE_TIME 2
+
+#define MAKE_DATETIME(year, month, day, hour, minute, second) \
+    (((DATETIME) (year) << 26) | ((DATETIME) (month) << 22) | ((DATETIME) (day) << 17) | ((DATETIME) (hour) << 12) | ((DATETIME) (minute) << 6) | (DATETIME) (second))
+#define DATETIME_YEAR(d) ((int) ((d) >> 26))
+#define DATETIME_MONTH(d) ((int) (((d) >> 22) & 0xF))
+#define DATETIME_DAY(d) ((int) (((d) >> 17) & 0x1F))
+#define DATETIME_HOUR(d) ((int) (((d) >> 12) & 0x1F))
+#define DATETIME_MINUTE(d) ((int) (((d) >> 6) & 0x3F))
+#define DATETIME_SECOND(d) ((int) ((d) & 0x3F))
+#define DATETIME_DATE(d) ((d) >> 17) // only the date (to compare dates without time)
+
+#define DATE_STRING_SIZE 20 // "nnnn/nn/nn nn:nn:nn" and the '\0', @see formatDate
+
+/* Typed fields */
+// the fields used by the queries are converted once, when the dataset is parsed (instead of every time a query reads them)
+typedef enum sex {
+    SEX_FEMALE = 'F',
+    SEX_MALE = 'M'
+} SEX; // the letter of the sex field, so it can be printed with %c
+
+typedef enum account_status {
+    ACCOUNT_INACTIVE,
+    ACCOUNT_ACTIVE
+} ACCOUNT_STATUS;
+
+typedef enum breakfast {
+    BREAKFAST_NOT_INCLUDED,
+    BREAKFAST_INCLUDED
+} BREAKFAST;
+
 /* Data Types */
 typedef struct User {
     char* id;
     char* name;
     char* email;
     char* phone_number;
-    char* birth_date;
-    char* sex;
     char* passport;
     char* country_code;
     char* address;
-    char* account_creation;
     char* pay_method;
-    char* account_status;
+    DATETIME birth_date;
+    DATETIME account_creation;
+    SEX sex;
+    ACCOUNT_STATUS account_status;
 } USER;
 
 typedef struct Flight {
     char *id;
     char* airline;
     char* plane_model;
-    char *total_seats;
     char* origin;
     char* destination;
-    char* schedule_departure_date;
-    char* schedule_arrival_date;
-    char* real_departure_date;
-    char* real_arrival_date;
     char* pilot;
     char* copilot;
     //char* notes;
+    DATETIME schedule_departure_date;
+    DATETIME schedule_arrival_date;
+    DATETIME real_departure_date;
+    DATETIME real_arrival_date;
+    int total_seats;
 } FLIGHT;
 
 /*typedef struct Passenger {
@@ -45,6 +85,14 @@ typedef struct Flight {
     char* user_id;
 } PASSENGER;*/
 
+// the flights that depart from an airport, sorted by schedule_departure_date (most recent first) and id (@see index_origin_flights)
+typedef struct airport_flights {
+    char* airport; // upper case
+    FLIGHT** flights;
+    int total_flights;
+    int median_delay; // median of the delays of the flights (query 7, @see get_flight_delay)
+} AIRPORT_FLIGHTS;
+
 // lets replace it by FLIGHT_SEATS
 typedef struct flight_seats {
     char* flight_id;
@@ -52,21 +100,94 @@ typedef struct flight_seats {
     int total_passengers;
 } FLIGHT_SEATS;
 
+// the passengers of each airport (origin or destination) in each year of schedule_departure_date (query 6, @see index_airport_passengers)
+typedef struct airport_passengers {
+    char **airports; // the airports (upper case), sorted by name
+    int airports_count;
+    GHashTable *years; // year -> int* (the passengers of each airport in the year, in the order of airports, -1 if no flight of the year has the airport)
+} AIRPORT_PASSENGERS;
+
+// the metrics of query 10 in a period (a year, a month or a day)
+typedef struct metrics {
+    int users; // users created (account_creation)
+    int flights; // flights that depart (schedule_departure_date)
+    int passengers; // passengers of the flights that depart
+    int unique_passengers; // users with, at least, a seat in the flights that depart
+    int reservations; // reservations that begin (begin_date)
+} METRICS;
+
+// the metrics of a year, of each of its months (months[month - 1]) and of each of its days (days[month - 1][day - 1])
+typedef struct year_metrics {
+    int year;
+    METRICS total;
+    METRICS months[12];
+    METRICS days[12][31];
+} YEAR_METRICS;
+
+// the metrics of query 10 by year, month and day (@see build_metrics_cube), only the years with records are kept
+typedef struct metrics_cube {
+    GHashTable *years; // year -> YEAR_METRICS
+    YEAR_METRICS **sorted_years; // the years, in ascending order
+    int years_count;
+} METRICS_CUBE;
+
+// the active users sorted by name in byte order (the users whose name starts with a prefix are consecutive) and, for each one,
+// its rank in the order of query 9 (by name and id, in the collation of the locale, @see index_user_names)
+typedef struct user_names {
+    USER **users;
+    guint *ranks; // ranks[i] is the position of users[i] in the collation order
+    int total_users;
+} USER_NAMES;
+
+// the flights of each user (the passengers table inverted), in compressed sparse rows:
+// the flights of the user in row r are flights[offsets[r]] to flights[offsets[r + 1] - 1] (a flight appears once per seat of the user)
+typedef struct user_flights {
+    GHashTable *rows; // user_id -> row + 1 (GUINT_TO_POINTER)
+    guint *offsets; // users_count + 1 offsets in flights
+    FLIGHT **flights; // the flights of all the users, packed by user
+    guint users_count;
+    guint flights_count;
+} USER_FLIGHTS;
+
 typedef struct Reservation {
     char* id; /* or make int but we need to remove the "Book00001" and get only the int*/
     char* user_id;
     char* hotel_id;
     char* hotel_name;
-    char* hotel_stars;
-    char* city_tax;
     char* address;
-    char* begin_date;
-    char* end_date;
-    char* price_per_night;
-    char* includes_breakfast;
     //char* room_details;
-    char* rating;
     //char* comment;
+    DATETIME begin_date;
+    DATETIME end_date;
+    int price_per_night;
+    int city_tax;
+    BREAKFAST includes_breakfast;
+    unsigned char hotel_stars; // 1 to 5
+    unsigned char rating; // 1 to 5
 } RESERVATION;
 
+// the reservations of a user (like FLIGHT_SEATS, but indexed by user)
+typedef struct user_reservations {
+    char* user_id;
+    RESERVATION** reservations; // in the file order
+    int total_reservations;
+} USER_RESERVATIONS;
+
+// the revenue of the nights of a hotel, as prefix sums over the days where the revenue per night changes (a reservation begins or ends)
+// the revenue of the nights before a day d, with days[i] <= d < days[i + 1], is revenue[i] + rates[i] * (d - days[i])
+typedef struct hotel_revenue {
+    int *days; // the days (@see calculate_day_number) where a reservation begins or ends, sorted
+    long long *rates; // revenue per night from days[i] to days[i + 1] - 1 (0 after the last day)
+    long long *revenue; // revenue of the nights before days[i]
+    int days_count;
+} HOTEL_REVENUE;
+
+// the reservations of a hotel, sorted by begin_date (most recent first) and id (@see index_hotel_reservations)
+typedef struct hotel_reservations {
+    char* hotel_id; // interned
+    RESERVATION** reservations;
+    int total_reservations;
+    HOTEL_REVENUE revenue; // the revenue of the nights of the reservations (the nights from begin_date to the day before end_date)
+} HOTEL_RESERVATIONS;
+
 #endif
\ No newline at end of file
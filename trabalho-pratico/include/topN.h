@@ -0,0 +1,30 @@
+/**
+ * @file topN.h
+ * @brief Header file for the top N selection (the best N of many items, without sorting all of them).
+ *
+ * The items are offered one by one and only the best N are kept, in a heap with the worst of them at the root:
+ * an item better than the root replaces it. Selecting the top N of M items costs O(M log N) time and O(N) memory.
+*/
+#ifndef TOPN_H
+#define TOPN_H
+
+#include <glib.h>
+
+// checks if an item comes before another in the result (returns 1 if a comes before b, 0 otherwise)
+typedef int (*TOP_N_BEFORE)(gconstpointer a, gconstpointer b, gconstpointer data);
+
+typedef struct top_n {
+    gpointer *heap; // the best items offered (the worst of them at the root)
+    int size; // number of items in the heap
+    int capacity; // size of the allocated heap (it only grows up to n, so a small n over many items allocates little)
+    int n; // maximum number of items kept
+    TOP_N_BEFORE before;
+    gconstpointer data; // passed to before (e.g. the values the items are compared by)
+} TOP_N;
+
+TOP_N *new_top_n(int n, TOP_N_BEFORE before, gconstpointer data);
+void top_n_offer(TOP_N *top, gpointer item);
+gpointer *top_n_sorted(TOP_N *top, int *size);
+void free_top_n(TOP_N *top);
+
+#endif
@@ -7,6 +7,6 @@
 #ifndef UNIT_TESTING_H
 #define UNIT_TESTING_H
 
-void run_unit_tests(char *outputDir, char *expectedOutputDir);
+int run_unit_tests(char *outputDir, char *expectedOutputDir);
 
 #endif
\ No newline at end of file
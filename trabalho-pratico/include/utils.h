@@ -7,12 +7,31 @@
 
 #define MAX_BUFFER_SIZE 1024
 
+#define ERROR_REGISTERY_BUFFER_SIZE (1 << 20) // size of each write buffer of an error registery (1 MiB)
+#define ERROR_REGISTERY_BUFFERS 2 // buffers of an error registery (one being filled while the other is written)
+
 #include <stdio.h>
+#include <stddef.h>
+#include <glib.h>
+
+typedef struct error_buffer {
+    char *data;
+    size_t used; // bytes of data filled with error lines
+} ERROR_BUFFER;
+
+typedef struct error_registery {
+    FILE *file;
+    ERROR_BUFFER *current; // the buffer being filled (NULL if the last one was sent to the writer)
+    int buffers_count; // number of buffers created (up to ERROR_REGISTERY_BUFFERS)
+    GAsyncQueue *full; // buffers waiting to be written, in order (consumed by the writer thread)
+    GAsyncQueue *empty; // buffers already written (reused by the parser)
+    GThread *writer;
+} ERROR_REGISTERY;
 
 char *toupper_str(const char *str);
-FILE *initialize_error_registery(const char *outputDir, const char *error_dataset);
-void register_error_line(FILE *file, const char *line);
-void close_error_registery(FILE *file);
+ERROR_REGISTERY *initialize_error_registery(const char *outputDir, const char *error_dataset);
+void register_error_line(ERROR_REGISTERY *registery, const char *line);
+void close_error_registery(ERROR_REGISTERY *registery);
 void save_result(int line, const char *res, const char *outputDirectory);
 FILE *initialize_file_saving(int line, const char *outputDirectory);
 void save_line(FILE *file, const char *line);
@@ -5,14 +5,22 @@
 #ifndef VALIDATION_H
 #define VALIDATION_H
 
+#include "structs.h"
+
+int parseDate(const char *date, DATETIME *parsed);
+int scanDate(const char *date, DATETIME *parsed);
+void formatDate(DATETIME date, int type, char *buffer);
 int validateDate(char *date);
 int validateDateWithoutTime(char *date);
 int validateDateWithTime(char* date);
+int compareParsedDates(DATETIME d1, int type1, DATETIME d2, int type2);
+int parseDateRange(const char *d1, const char *d2, DATETIME *parsed1, DATETIME *parsed2);
 int compareDates(char* d1, char* d2);
 int compareDatesWithoutTime(char* d1, char* d2);
 int compareDatesWithTime(char* d1, char* d2);
 int validateEmail(char *email);
 int validateCCode(char* country_code);
+int parseStatus(const char *account_status, ACCOUNT_STATUS *status);
 int isActive(char* account_status);
 int validateStatus(char* account_status);
 int validateSeats(int total_seats, int passengers);
@@ -21,6 +29,7 @@ int validateTrip(char* airport_depart, char* airport_arr);
 int validateStars(const char* hotel_stars);
 int validateTax(const char* city_tax);
 int validatePrice(const char* price_per_night);
+int parseBreakfast(const char *includes_breakfast, BREAKFAST *breakfast);
 int validateBreakfast(char* includes_breakfast);
 int validateRating(const char* rating);
 int validateFieldSize(const char* field);
@@ -0,0 +1,118 @@
+/**
+ * @file arena.c
+ * @brief Implementation of the arena (bump pointer) allocator of the catalog records.
+ */
+#include "arena.h"
+
+#include <string.h>
+#include <glib.h>
+
+// the blocks data starts right after the header (the header size is a multiple of the alignment)
+#define BLOCK_DATA(block) ((char *) (block) + sizeof(ARENA_BLOCK))
+
+/**
+ * @brief Creates a new (empty) arena. An arena is not thread safe, each thread must use its own arena. @see arena_merge
+ *
+ * @return ARENA* The new arena. @see struct ARENA
+ */
+ARENA *new_arena(void) {
+    ARENA *arena = g_new(ARENA, 1);
+    arena->blocks = NULL;
+    arena->allocations = 0;
+    arena->blocks_count = 0;
+    arena->bytes = 0;
+    return arena;
+}
+
+/**
+ * @brief Adds a new block to an arena (the block becomes the one being filled).
+ *
+ * @param arena The arena.
+ * @param size The minimum usable size of the block.
+ */
+static void add_arena_block(ARENA *arena, size_t size) {
+    if (size < ARENA_BLOCK_SIZE - sizeof(ARENA_BLOCK)) {
+        size = ARENA_BLOCK_SIZE - sizeof(ARENA_BLOCK);
+    }
+    ARENA_BLOCK *block = g_malloc(sizeof(ARENA_BLOCK) + size);
+    block->next = arena->blocks;
+    block->size = size;
+    block->used = 0;
+    arena->blocks = block;
+    arena->blocks_count++;
+}
+
+/**
+ * @brief Allocates memory in an arena (it is only freed with the arena, @see free_arena).
+ *
+ * @param arena The arena. @see new_arena
+ * @param size The size of the allocation.
+ * @return void* The allocated memory (aligned to ARENA_ALIGNMENT, not initialized).
+ */
+void *arena_alloc(ARENA *arena, size_t size) {
+    size = (size + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+    if (arena->blocks == NULL || arena->blocks->size - arena->blocks->used < size) {
+        add_arena_block(arena, size);
+    }
+    void *memory = BLOCK_DATA(arena->blocks) + arena->blocks->used;
+    arena->blocks->used += size;
+    arena->allocations++;
+    arena->bytes += size;
+    return memory;
+}
+
+/**
+ * @brief Copies data (e.g. a record built on the stack) into an arena.
+ *
+ * @param arena The arena. @see new_arena
+ * @param data The data to copy.
+ * @param size The size of the data.
+ * @return void* The copy.
+ */
+void *arena_copy(ARENA *arena, const void *data, size_t size) {
+    return memcpy(arena_alloc(arena, size), data, size);
+}
+
+/**
+ * @brief Moves the blocks of an arena (e.g. the arena of a parser worker) to another arena and frees the (now empty) source arena.
+ *      The memory allocated in the source arena stays valid, it is freed with the destination arena.
+ *
+ * @param destination The arena that receives the blocks.
+ * @param source The arena that is merged (it is freed).
+ */
+void arena_merge(ARENA *destination, ARENA *source) {
+    if (source->blocks != NULL) {
+        // the source blocks go under the destination block being filled, so it keeps being filled
+        ARENA_BLOCK *last = source->blocks;
+        while (last->next != NULL) {
+            last = last->next;
+        }
+        if (destination->blocks != NULL) {
+            last->next = destination->blocks->next;
+            destination->blocks->next = source->blocks;
+        } else {
+            destination->blocks = source->blocks;
+        }
+    }
+    destination->allocations += source->allocations;
+    destination->blocks_count += source->blocks_count;
+    destination->bytes += source->bytes;
+    g_free(source);
+}
+
+/**
+ * @brief Frees an arena and all the memory allocated in it (a free per block).
+ *
+ * @param arena The arena.
+ */
+void free_arena(ARENA *arena) {
+    if (arena != NULL) {
+        ARENA_BLOCK *block = arena->blocks;
+        while (block != NULL) {
+            ARENA_BLOCK *next = block->next;
+            g_free(block);
+            block = next;
+        }
+        g_free(arena);
+    }
+}
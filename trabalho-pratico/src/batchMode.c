@@ -6,6 +6,7 @@
 #include "interpreter.h"
 #include "queries.h"
 #include "utils.h"
+#include "lineReader.h"
 
 #include <time.h>
 
@@ -24,8 +25,9 @@ void log_ctime(clock_t start, clock_t end, int query_id, int runninTests) {
  * @param outputDirectory The output directory to save the result
  * @param c The passed catalog @see struct CATALOG
  * @param runninTests Flag to indicate if we are running tests or not
+ * @param result The buffer where the result of the query is built (it is cleared before the query, so it can be reused between commands)
  */
-void execute_command(int line, char* command, char* outputDirectory, CATALOG *c, int runninTests) {
+void execute_command(int line, char* command, char* outputDirectory, CATALOG *c, int runninTests, RESULT_BUFFER *result) {
 	char* result_command[3];
 	command_interpreter(command, result_command);
     /*printf("Line: %d\n", line);
@@ -88,6 +90,7 @@ void execute_command(int line, char* command, char* outputDirectory, CATALOG *c,
         printf("%s ", args[i]);
     }*/
     clock_t query_start, query_end;
+    clear_result_buffer(result);
 	switch (query_id) {
 		case 1:
             query_start = clock();
@@ -99,23 +102,13 @@ void execute_command(int line, char* command, char* outputDirectory, CATALOG *c,
             g_free(res_1);
 			break;
         case 2:
-            GList *res_2 = NULL;
             query_start = clock();
-            query_2(c, format_flag, args, args_size, &res_2);
+            query_2(c, format_flag, args, args_size, result);
             FILE *save_result_2 = initialize_file_saving(line, outputDirectory);
-            GList *iterList2 = res_2;
-            //printf("Data for command %d:\n", line);
-            while (iterList2 != NULL) {
-                char *str = iterList2->data;
-                //printf("%s", str);
-                save_line(save_result_2, str);
-                g_free(str);
-                iterList2 = g_list_next(iterList2);
-            }
+            write_result_buffer(result, save_result_2);
             close_file_saving(save_result_2);
             query_end = clock();
             log_ctime(query_start, query_end, query_id, runninTests);
-            g_list_free(res_2);
             break;
         case 3:
             query_start = clock();
@@ -127,80 +120,38 @@ void execute_command(int line, char* command, char* outputDirectory, CATALOG *c,
             g_free(res_3);
             break;
         case 4:
-            GList *res_4 = NULL;
             query_start = clock();
-            query_4(c, format_flag, args, args_size, &res_4);
+            query_4(c, format_flag, args, args_size, result);
             FILE *save_result_4 = initialize_file_saving(line, outputDirectory);
-            // Iterate through the list and save the result
-            GList *iterList4 = res_4;
-            //printf("Reservations for command %d:\n", line);
-            while (iterList4 != NULL) {
-                char *str = iterList4->data;
-                //printf("%s", str);
-                save_line(save_result_4, str);
-                g_free(str);
-                iterList4 = g_list_next(iterList4);
-            }
+            write_result_buffer(result, save_result_4);
             close_file_saving(save_result_4);
             query_end = clock();
             log_ctime(query_start, query_end, query_id, runninTests);
-            // Free the list
-            g_list_free(res_4);
             break;
         case 5:
-            GList *res_5 = NULL;
             query_start = clock();
-            query_5(c, format_flag, args, args_size, &res_5);
+            query_5(c, format_flag, args, args_size, result);
             FILE *save_result_5 = initialize_file_saving(line, outputDirectory);
-            GList *iterList5 = res_5;
-            //printf("Flights for command %d:\n", line);
-            while (iterList5 != NULL) {
-                char *str = iterList5->data;
-                //printf("%s", str);
-                save_line(save_result_5, str);
-                g_free(str);
-                iterList5 = g_list_next(iterList5);
-            }
+            write_result_buffer(result, save_result_5);
             close_file_saving(save_result_5);
             query_end = clock();
             log_ctime(query_start, query_end, query_id, runninTests);
-            g_list_free(res_5);
             break;
         case 6:
-            GList *res_6 = NULL;
             query_start = clock();
-            query_6(c, format_flag, args, args_size, &res_6);
+            query_6(c, format_flag, args, args_size, result);
             FILE *save_result_6 = initialize_file_saving(line, outputDirectory);
-            GList *iterList6 = res_6;
-            //printf("Flights for command %d:\n", line);
-            while (iterList6 != NULL) {
-                char *str = iterList6->data;
-                //printf("%s", str);
-                save_line(save_result_6, str);
-                g_free(str);
-                iterList6 = g_list_next(iterList6);
-            }
+            write_result_buffer(result, save_result_6);
             close_file_saving(save_result_6);
-            g_list_free(res_6);
             break;
         case 7:
-            GList *res_7 = NULL;
             query_start = clock();
-            query_7(c, format_flag, args, args_size, &res_7);
+            query_7(c, format_flag, args, args_size, result);
             FILE *save_result_7 = initialize_file_saving(line, outputDirectory);
-            GList *iterList7 = res_7;
-            //printf("Flights for command %d:\n", line);
-            while (iterList7 != NULL) {
-                char *str = iterList7->data;
-                //printf("%s", str);
-                save_line(save_result_7, str);
-                g_free(str);
-                iterList7 = g_list_next(iterList7);
-            }
+            write_result_buffer(result, save_result_7);
             close_file_saving(save_result_7);
             query_end = clock();
             log_ctime(query_start, query_end, query_id, runninTests);
-            g_list_free(res_7);
             break;
         case 8:
             char* res_8 = query_8(c, format_flag, args, args_size);
@@ -209,42 +160,22 @@ void execute_command(int line, char* command, char* outputDirectory, CATALOG *c,
             g_free(res_8);
             break;
         case 9:
-            GList *res_9 = NULL;
             query_start = clock();
-            query_9(c, format_flag, args, args_size, &res_9);
+            query_9(c, format_flag, args, args_size, result);
             FILE *save_result_9 = initialize_file_saving(line, outputDirectory);
-            GList *iterList9 = res_9;
-            //printf("User for command %d:\n", line);
-            while (iterList9 != NULL) {
-                char *str = iterList9->data;
-                //printf("%s", str);
-                save_line(save_result_9, str);
-                g_free(str);
-                iterList9 = g_list_next(iterList9);
-            }
+            write_result_buffer(result, save_result_9);
             close_file_saving(save_result_9);
             query_end = clock();
             log_ctime(query_start, query_end, query_id, runninTests);
-            g_list_free(res_9);
-            break;  
+            break;
         case 10:
-            GList *res_10 = NULL;
             query_start = clock();
-            //query_10(c, format_flag, args, args_size, &res_10);
+            query_10(c, format_flag, args, args_size, result);
             FILE *save_result_10 = initialize_file_saving(line, outputDirectory);
-            GList *iterList10 = res_10;
-            //printf("User for command %d:\n", line);
-            while (iterList10 != NULL) {
-                char *str = iterList10->data;
-                //printf("%s", str);
-                save_line(save_result_10, str);
-                g_free(str);
-                iterList10 = g_list_next(iterList10);
-            }
+            write_result_buffer(result, save_result_10);
             close_file_saving(save_result_10);
             query_end = clock();
             log_ctime(query_start, query_end, query_id, runninTests);
-            g_list_free(res_10);
             break;
 		default:
 			printf("Query ID inválido!\n");
@@ -268,12 +199,17 @@ void batchMode(char *inputFile, char *outputDirectory, CATALOG *c, int runninTes
         perror("Error opening input file!\n");
         exit(1);
     }
-    char *command = g_malloc(sizeof(char) * MAX_COMMAND_SIZE);
+    // the commands can have any length (e.g. long names in the arguments)
+    LINE_READER *reader = new_line_reader(fp);
+    // the same result buffer is used by all the commands (it only grows until it fits the biggest result)
+    RESULT_BUFFER *result = new_result_buffer();
+    char *command;
     int line = 1;
-    while (fgets(command, MAX_COMMAND_SIZE, fp) != NULL) {
-        execute_command(line, command, outputDirectory, c, runninTests);
+    while ((command = read_line(reader, NULL)) != NULL) {
+        execute_command(line, command, outputDirectory, c, runninTests, result);
         line++;
     }
-    g_free(command);
+    free_result_buffer(result);
+    free_line_reader(reader);
     fclose(fp);
 }
\ No newline at end of file
@@ -0,0 +1,871 @@
+/**
+ * @file benchmark.c
+ * @brief Microbenchmarks of the hot paths of the program, over the files of a dataset.
+ */
+#include "benchmark.h"
+#include "structs.h"
+#include "mappedFile.h"
+#include "fieldScanner.h"
+#include "validation.h"
+#include "catalog.h"
+#include "loader.h"
+#include "arena.h"
+#include "utils.h"
+#include "snapshot.h"
+#include "statistics.h"
+#include "topN.h"
+#include "parsers/reservations.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <glib.h>
+
+#define BENCHMARK_ROUNDS 5
+
+typedef struct benchmark_file {
+    const char *name;
+    int fields; // number of fields of the records
+} BENCHMARK_FILE;
+
+static const BENCHMARK_FILE benchmark_files[] = {
+    { "users.csv", 12 },
+    { "flights.csv", 13 },
+    { "reservations.csv", 14 },
+    { "passengers.csv", 2 }
+};
+
+/**
+ * @brief Splits every record of a buffer the way the parsers did before the field scanner:
+ *      a copy of the line (like fgets), strcspn to remove the '\n' and g_strsplit (and g_strfreev).
+ *
+ * @param data The buffer (ends with a '\0').
+ * @param size The size of the buffer.
+ * @param fields Not used (same signature as the other splitters).
+ * @return long The total number of fields (so the work is not optimized away).
+ */
+static long split_with_g_strsplit(char *data, size_t size, int fields) {
+    (void) fields;
+    char line[MAX_LINE_SIZE];
+    char *p = data;
+    char *end = data + size;
+    long total = 0;
+    while (p < end) {
+        char *newline = memchr(p, '\n', end - p);
+        size_t length = (newline != NULL ? newline + 1 : end) - p;
+        if (length > MAX_LINE_SIZE - 1) {
+            length = MAX_LINE_SIZE - 1;
+        }
+        memcpy(line, p, length);
+        line[length] = '\0';
+        line[strcspn(line, "\n")] = '\0';
+        gchar **tokens = g_strsplit(line, ";", -1);
+        total += g_strv_length(tokens);
+        g_strfreev(tokens);
+        p = newline != NULL ? newline + 1 : end;
+    }
+    return total;
+}
+
+/**
+ * @brief Splits every record of a buffer with a field scanner. @see scan_fields_using
+ *
+ * @param scanner The scanner.
+ * @param data The buffer (ends with a '\0', it is modified).
+ * @param size The size of the buffer.
+ * @param fields The number of fields of the records.
+ * @return long The total number of fields (so the work is not optimized away).
+ */
+static long split_with_scanner(FIELD_SCANNER scanner, char *data, size_t size, int fields) {
+    char *tokens[fields];
+    char *p = data;
+    char *end = data + size;
+    long total = 0;
+    while (p < end) {
+        int fields_count;
+        p = scan_fields_using(scanner, p, end, tokens, fields, &fields_count);
+        total += fields_count;
+    }
+    return total;
+}
+
+/**
+ * @brief Runs a splitter over a file a few times (on a fresh copy each time) and prints the best throughput.
+ *
+ * @param method The name of the splitter.
+ * @param scanner The scanner (ignored if use_scanner is 0).
+ * @param use_scanner 1 to use the field scanner, 0 to use g_strsplit.
+ * @param file The contents of the file.
+ * @param size The size of the file.
+ * @param fields The number of fields of the records.
+ */
+static void benchmark_splitter(const char *method, FIELD_SCANNER scanner, int use_scanner, const char *file, size_t size, int fields) {
+    char *work = g_malloc(size + 1);
+    gint64 best = G_MAXINT64;
+    long total = 0;
+    for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+        memcpy(work, file, size + 1);
+        gint64 start = g_get_monotonic_time();
+        if (use_scanner) {
+            total = split_with_scanner(scanner, work, size, fields);
+        } else {
+            total = split_with_g_strsplit(work, size, fields);
+        }
+        gint64 elapsed = g_get_monotonic_time() - start;
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+    double seconds = best > 0 ? (double) best / G_USEC_PER_SEC : 1.0 / G_USEC_PER_SEC;
+    printf("    %-12s %10.2f MB/s  %10.6fs  (%ld fields)\n", method, size / seconds / 1e6, seconds, total);
+    g_free(work);
+}
+
+/**
+ * @brief Compares the throughput (bytes/s) of g_strsplit and of the field scanners on the files of a dataset.
+ *
+ * @param datasetDir The directory of the dataset.
+ */
+static void benchmark_field_scanners(const char *datasetDir) {
+    printf("Field scanner (best of %d rounds, best scanner on this machine: %s)\n", BENCHMARK_ROUNDS, field_scanner_name(best_field_scanner()));
+    for (size_t i = 0; i < sizeof(benchmark_files) / sizeof(benchmark_files[0]); i++) {
+        MAPPED_FILE *file = open_mapped_dataset(datasetDir, benchmark_files[i].name);
+        printf("  %s (%zu bytes)\n", benchmark_files[i].name, file->size);
+        benchmark_splitter("g_strsplit", SCANNER_SCALAR, 0, file->data, file->size, benchmark_files[i].fields);
+        benchmark_splitter("scalar", SCANNER_SCALAR, 1, file->data, file->size, benchmark_files[i].fields);
+        benchmark_splitter("sse2", SCANNER_SSE2, 1, file->data, file->size, benchmark_files[i].fields);
+        benchmark_splitter("avx2", SCANNER_AVX2, 1, file->data, file->size, benchmark_files[i].fields);
+        close_mapped_dataset(file);
+    }
+}
+
+typedef struct date_columns {
+    const char *name;
+    int fields; // number of fields of the records
+    int first; // column of the first date of each pair
+    int second; // column of the second date of each pair
+} DATE_COLUMNS;
+
+// the pairs of dates validated by the parsers (the first must happen before the second)
+static const DATE_COLUMNS date_columns[] = {
+    { "users.csv", 12, 4, 9 },
+    { "flights.csv", 13, 6, 7 },
+    { "flights.csv", 13, 8, 9 },
+    { "reservations.csv", 14, 7, 8 }
+};
+
+/**
+ * @brief The date validation used before the packed date parser (g_strdup and strtok of the date), kept as a reference.
+ *
+ * @param date The date.
+ * @param values Where the year, month, day, hour, minute and second are saved (the time is 0 for dates without time).
+ * @return int 2 if it is a valid date with time, 1 if it is a valid date without time, 0 otherwise.
+ */
+static int legacy_parse_date(const char *date, int values[6]) {
+    int with_time = strchr(date, ' ') != NULL;
+    char *date_copy = g_strdup(date);
+    char *saveptr;
+    char *tokens[6] = { NULL, NULL, NULL, NULL, NULL, NULL };
+    tokens[0] = strtok_r(date_copy, "/", &saveptr);
+    tokens[1] = strtok_r(NULL, "/", &saveptr);
+    tokens[2] = strtok_r(NULL, with_time ? " " : "/", &saveptr);
+    int count = 3;
+    if (with_time) {
+        tokens[3] = strtok_r(NULL, ":", &saveptr);
+        tokens[4] = strtok_r(NULL, ":", &saveptr);
+        tokens[5] = strtok_r(NULL, ":", &saveptr);
+        count = 6;
+    }
+    int valid = 1;
+    for (int i = 0; i < 6; i++) {
+        values[i] = 0;
+    }
+    for (int i = 0; i < count && valid; i++) {
+        if (tokens[i] == NULL || strlen(tokens[i]) != (i == 0 ? 4u : 2u)) {
+            valid = 0;
+        } else {
+            values[i] = atoi(tokens[i]);
+        }
+    }
+    if (valid && (values[0] == 0 || values[1] < 1 || values[1] > 12 || values[2] < 1 || values[2] > 31 || values[3] > 23 || values[4] > 59 || values[5] > 59)) {
+        valid = 0;
+    }
+    g_free(date_copy);
+    return valid ? 1 + with_time : 0;
+}
+
+/**
+ * @brief The validation chain used before the packed date parser: both dates validated and then parsed again to be compared.
+ *
+ * @param d1 The first date.
+ * @param d2 The second date.
+ * @return int 1 if d1 happens first than d2, -1 if d2 happens first than d1 (or a date is invalid), 0 if they are the same.
+ */
+static int legacy_compare_dates(const char *d1, const char *d2) {
+    int v1[6], v2[6];
+    if (legacy_parse_date(d1, v1) == 0 || legacy_parse_date(d2, v2) == 0) {
+        return -1;
+    }
+    int type1 = legacy_parse_date(d1, v1);
+    int type2 = legacy_parse_date(d2, v2);
+    int count = type1 == 2 && type2 == 2 ? 6 : 3;
+    for (int i = 0; i < count; i++) {
+        if (v1[i] != v2[i]) {
+            return v1[i] < v2[i] ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Compares the throughput of the date validation chains (legacy strtok based and packed date parser) on the dates of a dataset.
+ *
+ * @param datasetDir The directory of the dataset.
+ */
+static void benchmark_date_validation(const char *datasetDir) {
+    printf("Date validation (best of %d rounds)\n", BENCHMARK_ROUNDS);
+    for (size_t i = 0; i < sizeof(date_columns) / sizeof(date_columns[0]); i++) {
+        const DATE_COLUMNS *columns = &date_columns[i];
+        MAPPED_FILE *file = open_mapped_dataset(datasetDir, columns->name);
+        GPtrArray *pairs = g_ptr_array_new();
+        char *tokens[columns->fields];
+        int fields_count;
+        next_mapped_line(file); // header
+        while (next_mapped_record(file, tokens, columns->fields, &fields_count) != NULL) {
+            g_ptr_array_add(pairs, tokens[columns->first]);
+            g_ptr_array_add(pairs, tokens[columns->second]);
+        }
+        guint total_pairs = pairs->len / 2;
+
+        gint64 best_legacy = G_MAXINT64, best_packed = G_MAXINT64;
+        long valid_legacy = 0, valid_packed = 0;
+        for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+            gint64 start = g_get_monotonic_time();
+            valid_legacy = 0;
+            for (guint j = 0; j < pairs->len; j += 2) {
+                valid_legacy += legacy_compare_dates(g_ptr_array_index(pairs, j), g_ptr_array_index(pairs, j + 1)) == 1;
+            }
+            gint64 elapsed = g_get_monotonic_time() - start;
+            best_legacy = elapsed < best_legacy ? elapsed : best_legacy;
+
+            start = g_get_monotonic_time();
+            valid_packed = 0;
+            for (guint j = 0; j < pairs->len; j += 2) {
+                DATETIME first, second;
+                valid_packed += parseDateRange(g_ptr_array_index(pairs, j), g_ptr_array_index(pairs, j + 1), &first, &second) == 1;
+            }
+            elapsed = g_get_monotonic_time() - start;
+            best_packed = elapsed < best_packed ? elapsed : best_packed;
+        }
+        double legacy_seconds = best_legacy > 0 ? (double) best_legacy / G_USEC_PER_SEC : 1.0 / G_USEC_PER_SEC;
+        double packed_seconds = best_packed > 0 ? (double) best_packed / G_USEC_PER_SEC : 1.0 / G_USEC_PER_SEC;
+        printf("  %s columns %d and %d (%u pairs)\n", columns->name, columns->first, columns->second, total_pairs);
+        printf("    %-12s %10.2f M pairs/s  %10.6fs  (%ld valid)\n", "strtok", total_pairs / legacy_seconds / 1e6, legacy_seconds, valid_legacy);
+        printf("    %-12s %10.2f M pairs/s  %10.6fs  (%ld valid)\n", "packed", total_pairs / packed_seconds / 1e6, packed_seconds, valid_packed);
+        g_ptr_array_free(pairs, TRUE);
+        close_mapped_dataset(file);
+    }
+}
+
+/**
+ * @brief Gets the resident set size of the process (from /proc/self/statm).
+ *
+ * @return double The resident set size in MiB (0 if it can not be read).
+ */
+static double resident_mib(void) {
+    long pages = 0, resident = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm != NULL) {
+        if (fscanf(statm, "%ld %ld", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        fclose(statm);
+    }
+    return (double) resident * sysconf(_SC_PAGESIZE) / (1 << 20);
+}
+
+/**
+ * @brief Measures the memory of the catalog records: allocations, resident set size and teardown time.
+ *      The records are allocated in arenas, the reference is the same records allocated one by one
+ *      (a g_malloc per record and per passengers array, freed one by one), as the parsers did before the arenas.
+ *
+ * @param datasetDir The directory of the dataset.
+ */
+static void benchmark_catalog_memory(const char *datasetDir) {
+    // the errors files are written to a temporary directory
+    char *outputDir = g_dir_make_tmp("benchmark-XXXXXX", NULL);
+    if (outputDir == NULL) {
+        perror("Error creating temporary directory");
+        return;
+    }
+    double rss_before = resident_mib();
+    CATALOG *c = newCatalog(NULL, NULL, NULL, NULL);
+    load_catalog(c, datasetDir, outputDir, NULL);
+    double rss_loaded = resident_mib();
+
+    size_t allocations = 0, blocks = 0, bytes = 0;
+    for (guint i = 0; i < c->arenas->len; i++) {
+        ARENA *arena = g_ptr_array_index(c->arenas, i);
+        allocations += arena->allocations;
+        blocks += arena->blocks_count;
+        bytes += arena->bytes;
+    }
+    guint users = g_hash_table_size(c->users), flights = g_hash_table_size(c->flights);
+    guint reservations = g_hash_table_size(c->reservations), flight_seats = g_hash_table_size(c->passengers);
+
+    // reference: the same records, one heap allocation each
+    gint64 start = g_get_monotonic_time();
+    GPtrArray *records = g_ptr_array_sized_new(allocations);
+    for (guint i = 0; i < users; i++) {
+        g_ptr_array_add(records, g_malloc(sizeof(USER)));
+    }
+    for (guint i = 0; i < flights; i++) {
+        g_ptr_array_add(records, g_malloc(sizeof(FLIGHT)));
+    }
+    for (guint i = 0; i < reservations; i++) {
+        g_ptr_array_add(records, g_malloc(sizeof(RESERVATION)));
+    }
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, c->passengers);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT_SEATS *seats = (FLIGHT_SEATS *) value;
+        g_ptr_array_add(records, g_malloc(sizeof(FLIGHT_SEATS)));
+        g_ptr_array_add(records, g_malloc(seats->total_passengers * sizeof(char*)));
+    }
+    gint64 heap_alloc_time = g_get_monotonic_time() - start;
+    double rss_heap = resident_mib();
+    start = g_get_monotonic_time();
+    for (guint i = 0; i < records->len; i++) {
+        g_free(g_ptr_array_index(records, i));
+    }
+    gint64 heap_free_time = g_get_monotonic_time() - start;
+    guint heap_allocations = records->len;
+    g_ptr_array_free(records, TRUE);
+
+    start = g_get_monotonic_time();
+    free_catalog(c);
+    gint64 teardown_time = g_get_monotonic_time() - start;
+
+    printf("Catalog records (%u users, %u flights, %u reservations, %u flights with passengers)\n", users, flights, reservations, flight_seats);
+    printf("  %-12s %10zu allocations in %zu blocks, %.1f MiB of records\n", "arenas", allocations, blocks, (double) bytes / (1 << 20));
+    printf("  %-12s %10u allocations (%.6fs to allocate, %.6fs to free, %.1f MiB more resident)\n", "one by one", heap_allocations, (double) heap_alloc_time / G_USEC_PER_SEC, (double) heap_free_time / G_USEC_PER_SEC, rss_heap - rss_loaded);
+    printf("  resident set size: %.1f MiB before loading, %.1f MiB loaded\n", rss_before, rss_loaded);
+    printf("  free_catalog (hash tables, arenas and mapped files): %.6fs\n", (double) teardown_time / G_USEC_PER_SEC);
+
+    const char *errors_files[] = { "users_errors.csv", "flights_errors.csv", "reservations_errors.csv", "passengers_errors.csv" };
+    for (size_t i = 0; i < sizeof(errors_files) / sizeof(errors_files[0]); i++) {
+        char *path = g_build_filename(outputDir, errors_files[i], NULL);
+        remove(path);
+        g_free(path);
+    }
+    remove(outputDir);
+    g_free(outputDir);
+}
+
+/**
+ * @brief Compares the error registery (buffers written by a writer thread) with a fprintf per line (as the parsers did before),
+ *      registering every line of the files of a dataset as an error (the worst case, a dataset where every record is invalid).
+ *      The time of the parser (until the last line is registered) and the total time (until the file is closed) are printed.
+ *
+ * @param datasetDir The directory of the dataset.
+ */
+static void benchmark_error_registery(const char *datasetDir) {
+    char *outputDir = g_dir_make_tmp("benchmark-XXXXXX", NULL);
+    if (outputDir == NULL) {
+        perror("Error creating temporary directory");
+        return;
+    }
+    char *path = g_build_filename(outputDir, "errors.csv", NULL);
+    printf("Error registery (every line registered as an error, best of %d rounds)\n", BENCHMARK_ROUNDS);
+    for (size_t i = 0; i < sizeof(benchmark_files) / sizeof(benchmark_files[0]); i++) {
+        MAPPED_FILE *file = open_mapped_dataset(datasetDir, benchmark_files[i].name);
+        GPtrArray *lines = g_ptr_array_new();
+        char *line;
+        while ((line = next_mapped_line(file)) != NULL) {
+            g_ptr_array_add(lines, line);
+        }
+        gint64 best_fprintf = G_MAXINT64, best_parser = G_MAXINT64, best_total = G_MAXINT64;
+        for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+            gint64 start = g_get_monotonic_time();
+            FILE *fp = fopen(path, "w");
+            if (fp == NULL) {
+                perror("Error opening file");
+                exit(EXIT_FAILURE);
+            }
+            for (guint j = 0; j < lines->len; j++) {
+                fprintf(fp, "%s\n", (char *) g_ptr_array_index(lines, j));
+            }
+            fclose(fp);
+            gint64 elapsed = g_get_monotonic_time() - start;
+            if (elapsed < best_fprintf) {
+                best_fprintf = elapsed;
+            }
+
+            start = g_get_monotonic_time();
+            ERROR_REGISTERY *registery = initialize_error_registery(outputDir, "errors.csv");
+            for (guint j = 0; j < lines->len; j++) {
+                register_error_line(registery, g_ptr_array_index(lines, j));
+            }
+            gint64 parser = g_get_monotonic_time() - start;
+            close_error_registery(registery);
+            elapsed = g_get_monotonic_time() - start;
+            if (parser < best_parser) {
+                best_parser = parser;
+            }
+            if (elapsed < best_total) {
+                best_total = elapsed;
+            }
+        }
+        printf("  %s (%u lines)\n", benchmark_files[i].name, lines->len);
+        printf("    %-12s %10.6fs\n", "fprintf", (double) best_fprintf / G_USEC_PER_SEC);
+        printf("    %-12s %10.6fs in the parser, %.6fs until closed\n", "registery", (double) best_parser / G_USEC_PER_SEC, (double) best_total / G_USEC_PER_SEC);
+        g_ptr_array_free(lines, TRUE);
+        close_mapped_dataset(file);
+    }
+    remove(path);
+    g_free(path);
+    remove(outputDir);
+    g_free(outputDir);
+}
+
+/**
+ * @brief Damages a copy of a valid snapshot (some bytes are replaced or the file is truncated) and checks that it is not loaded.
+ *
+ * @param path The path of the valid snapshot.
+ * @param copy The path where the damaged copy is written.
+ * @param damage What is damaged (printed).
+ * @param offset Where the bytes are replaced (or the size of the truncated copy).
+ * @param bytes The new bytes (NULL to truncate the copy).
+ * @param size The number of bytes.
+ */
+static void check_damaged_snapshot(const char *path, const char *copy, const char *damage, size_t offset, const void *bytes, size_t size) {
+    gchar *contents = NULL;
+    gsize length = 0;
+    if (!g_file_get_contents(path, &contents, &length, NULL)) {
+        return;
+    }
+    if (bytes == NULL) {
+        length = MIN(offset, length);
+    } else if (offset + size <= length) {
+        memcpy(contents + offset, bytes, size);
+    }
+    int loaded = 0;
+    if (g_file_set_contents(copy, contents, length, NULL)) {
+        CATALOG *c = newCatalog(NULL, NULL, NULL, NULL);
+        loaded = load_snapshot(c, copy);
+        free_catalog(c);
+    }
+    printf("  %-24s %s\n", damage, loaded ? "LOADED (it should be rejected)" : "rejected");
+    g_free(contents);
+}
+
+/**
+ * @brief Checks that damaged snapshots are rejected by load_snapshot (instead of loading records that would be used out of bounds).
+ *
+ * @param path The path of a valid snapshot (with at least a record of each dataset).
+ * @param outputDir The directory where the damaged copies are written (they are removed).
+ */
+static void check_damaged_snapshots(const char *path, const char *outputDir) {
+    SNAPSHOT_HEADER header;
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return;
+    }
+    size_t read = fread(&header, sizeof(SNAPSHOT_HEADER), 1, file);
+    fclose(file);
+    if (read != 1) {
+        return;
+    }
+    char *copy = g_build_filename(outputDir, "damaged.snapshot", NULL);
+    printf("Damaged snapshots\n");
+    check_damaged_snapshot(path, copy, "magic", 0, "XXXXXXX", 8);
+    check_damaged_snapshot(path, copy, "truncated", header.strings.offset + header.strings.count / 2, NULL, 0);
+    guint64 bad_offset = G_MAXUINT64;
+    if (header.users.count > 0) {
+        check_damaged_snapshot(path, copy, "user id offset", header.users.offset + offsetof(USER, id), &bad_offset, sizeof(bad_offset));
+        // dates with month 13, month 0 and day 0 (they would be used as indexes of the metrics of query 10)
+        DATETIME date = MAKE_DATETIME(2023, 13, 1, 0, 0, 0);
+        check_damaged_snapshot(path, copy, "user date (month 13)", header.users.offset + offsetof(USER, account_creation), &date, sizeof(date));
+    }
+    if (header.flights.count > 0) {
+        DATETIME date = MAKE_DATETIME(2023, 0, 1, 0, 0, 0);
+        check_damaged_snapshot(path, copy, "flight date (month 0)", header.flights.offset + offsetof(FLIGHT, schedule_departure_date), &date, sizeof(date));
+    }
+    if (header.reservations.count > 0) {
+        DATETIME date = MAKE_DATETIME(2023, 1, 0, 0, 0, 0);
+        check_damaged_snapshot(path, copy, "reservation date (day 0)", header.reservations.offset + offsetof(RESERVATION, begin_date), &date, sizeof(date));
+    }
+    remove(copy);
+    g_free(copy);
+}
+
+/**
+ * @brief Compares loading a dataset from the CSVs (parsing and validating them) with loading it from a snapshot of the same catalog.
+ *
+ * @param datasetDir The directory of the dataset.
+ */
+static void benchmark_snapshot(const char *datasetDir) {
+    char *outputDir = g_dir_make_tmp("benchmark-XXXXXX", NULL);
+    if (outputDir == NULL) {
+        perror("Error creating temporary directory");
+        return;
+    }
+    char *path = g_build_filename(outputDir, "catalog.snapshot", NULL);
+    CATALOG *c = newCatalog(NULL, NULL, NULL, NULL);
+    gint64 start = g_get_monotonic_time();
+    load_catalog(c, datasetDir, outputDir, NULL);
+    gint64 csv_time = g_get_monotonic_time() - start;
+    start = g_get_monotonic_time();
+    save_snapshot(c, path);
+    gint64 save_time = g_get_monotonic_time() - start;
+    free_catalog(c);
+
+    c = newCatalog(NULL, NULL, NULL, NULL);
+    start = g_get_monotonic_time();
+    int loaded = load_snapshot(c, path);
+    gint64 snapshot_time = g_get_monotonic_time() - start;
+    MAPPED_FILE *snapshot = loaded ? g_ptr_array_index(c->sources, 0) : NULL;
+    printf("Catalog snapshot (%zu bytes)\n", snapshot != NULL ? snapshot->size : (size_t) 0);
+    printf("  %-12s %10.6fs\n", "csv", (double) csv_time / G_USEC_PER_SEC);
+    printf("  %-12s %10.6fs (saved in %.6fs)\n", "snapshot", (double) snapshot_time / G_USEC_PER_SEC, (double) save_time / G_USEC_PER_SEC);
+    free_catalog(c);
+    check_damaged_snapshots(path, outputDir);
+
+    const char *files[] = { "catalog.snapshot", "users_errors.csv", "flights_errors.csv", "reservations_errors.csv", "passengers_errors.csv" };
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        char *file = g_build_filename(outputDir, files[i], NULL);
+        remove(file);
+        g_free(file);
+    }
+    g_free(path);
+    remove(outputDir);
+    g_free(outputDir);
+}
+
+/**
+ * @brief Counts the flights of a user going through all the passengers (as the flights of a user were found before the index).
+ *
+ * @param passengers The passengers hash table.
+ * @param user_id The user id.
+ * @return int The number of flights of the user.
+ */
+static int scan_user_flights(GHashTable *passengers, const char *user_id) {
+    int count = 0;
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, passengers);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT_SEATS *flight_seats = (FLIGHT_SEATS *) value;
+        for (int i = 0; i < flight_seats->total_passengers; i++) {
+            if (strcmp(flight_seats->passengers[i], user_id) == 0) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Removes a temporary output directory of a benchmark, with the errors files written by load_catalog.
+ *
+ * @param outputDir The directory (it is freed).
+ */
+static void remove_benchmark_output(char *outputDir) {
+    const char *files[] = { "users_errors.csv", "flights_errors.csv", "reservations_errors.csv", "passengers_errors.csv" };
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        char *file = g_build_filename(outputDir, files[i], NULL);
+        remove(file);
+        g_free(file);
+    }
+    remove(outputDir);
+    g_free(outputDir);
+}
+
+/**
+ * @brief Measures the memory of the index of the flights of each user and the time of a lookup, with the index and with a scan of the passengers.
+ *
+ * @param datasetDir The directory of the dataset.
+ */
+static void benchmark_user_flights(const char *datasetDir) {
+    char *outputDir = g_dir_make_tmp("benchmark-XXXXXX", NULL);
+    if (outputDir == NULL) {
+        perror("Error creating temporary directory");
+        return;
+    }
+    CATALOG *c = newCatalog(NULL, NULL, NULL, NULL);
+    load_catalog(c, datasetDir, outputDir, NULL);
+    USER_FLIGHTS *index = c->user_flights;
+    // the rows hash table keeps a key, a value and a hash for each user
+    size_t rows_bytes = (size_t) index->users_count * (2 * sizeof(gpointer) + sizeof(guint));
+    size_t offsets_bytes = ((size_t) index->users_count + 1) * sizeof(guint);
+    size_t flights_bytes = (size_t) index->flights_count * sizeof(FLIGHT*);
+    printf("User flights index (%u users, %u flights)\n", index->users_count, index->flights_count);
+    printf("  %-12s %10zu bytes\n", "rows", rows_bytes);
+    printf("  %-12s %10zu bytes\n", "offsets", offsets_bytes);
+    printf("  %-12s %10zu bytes\n", "flights", flights_bytes);
+
+    // the lookups are done for the users of the dataset (with and without flights), the scan only for a few of them
+    GPtrArray *user_ids = g_ptr_array_new();
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, c->users);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        g_ptr_array_add(user_ids, key);
+    }
+    guint scanned = MIN(user_ids->len, 100);
+    long checksum = 0;
+    gint64 start = g_get_monotonic_time();
+    for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+        for (guint i = 0; i < user_ids->len; i++) {
+            checksum += count_number_flights(c, g_ptr_array_index(user_ids, i));
+        }
+    }
+    gint64 index_time = g_get_monotonic_time() - start;
+    start = g_get_monotonic_time();
+    for (guint i = 0; i < scanned; i++) {
+        checksum -= scan_user_flights(c->passengers, g_ptr_array_index(user_ids, i));
+    }
+    gint64 scan_time = g_get_monotonic_time() - start;
+    if (user_ids->len > 0) {
+        printf("  %-12s %10.3fus per lookup\n", "index", (double) index_time / ((double) user_ids->len * BENCHMARK_ROUNDS));
+        printf("  %-12s %10.3fus per lookup (%u lookups, checksum %ld)\n", "scan", (double) scan_time / scanned, scanned, checksum);
+    }
+    g_ptr_array_free(user_ids, TRUE);
+    free_catalog(c);
+    remove_benchmark_output(outputDir);
+}
+
+#define BENCHMARK_AIRPORTS (1 << 20) // number of airports of the top N benchmark (far more than any dataset has)
+
+/**
+ * @brief Checks if an airport comes before another in a top (more passengers or, with the same passengers, the first column).
+ *
+ * @param a The column of the first airport (GINT_TO_POINTER).
+ * @param b The column of the second airport (GINT_TO_POINTER).
+ * @param data The passengers of each airport (int*).
+ * @return int 1 if a comes before b, 0 otherwise.
+ */
+static int benchmark_airport_before(gconstpointer a, gconstpointer b, gconstpointer data) {
+    const int *row = data;
+    int column_a = GPOINTER_TO_INT(a), column_b = GPOINTER_TO_INT(b);
+    return row[column_a] > row[column_b] || (row[column_a] == row[column_b] && column_a < column_b);
+}
+
+/**
+ * @brief Compares two airports by passengers (most first) and column (for g_qsort_with_data).
+ *
+ * @param a A pointer to the column of the first airport (int*).
+ * @param b A pointer to the column of the second airport (int*).
+ * @param data The passengers of each airport (int*).
+ * @return gint The comparator (< 0 if a comes first).
+ */
+static gint compare_benchmark_airports(gconstpointer a, gconstpointer b, gpointer data) {
+    int column_a = *(const int *) a, column_b = *(const int *) b;
+    if (column_a == column_b) return 0;
+    return benchmark_airport_before(GINT_TO_POINTER(column_a), GINT_TO_POINTER(column_b), data) ? -1 : 1;
+}
+
+/**
+ * @brief Measures the selection of the top N of many airports (like queries 6 and 7) with a top N heap and with a sort of all the airports.
+ *      The passengers of the airports are generated (with many ties, so the tiebreaker is used).
+ *
+ * @param datasetDir The directory of the dataset (not used, the airports are generated).
+ */
+static void benchmark_top_n(const char *datasetDir) {
+    (void) datasetDir;
+    int *row = g_new(int, BENCHMARK_AIRPORTS);
+    int *columns = g_new(int, BENCHMARK_AIRPORTS);
+    guint32 seed = 12345;
+    for (int i = 0; i < BENCHMARK_AIRPORTS; i++) {
+        seed = seed * 1103515245 + 12345;
+        row[i] = (int) ((seed >> 8) % 100000);
+    }
+    printf("Top N of %d airports\n", BENCHMARK_AIRPORTS);
+    const int tops[] = { 1, 10, 100, 1000 };
+    for (size_t t = 0; t < sizeof(tops) / sizeof(tops[0]); t++) {
+        int n = tops[t];
+        long checksum = 0;
+        gint64 start = g_get_monotonic_time();
+        for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+            TOP_N *top = new_top_n(n, benchmark_airport_before, row);
+            for (int i = 0; i < BENCHMARK_AIRPORTS; i++) {
+                top_n_offer(top, GINT_TO_POINTER(i));
+            }
+            int size = 0;
+            gpointer *airports = top_n_sorted(top, &size);
+            for (int i = 0; i < size; i++) {
+                checksum += (long) (i + 1) * GPOINTER_TO_INT(airports[i]);
+            }
+            free_top_n(top);
+        }
+        gint64 heap_time = g_get_monotonic_time() - start;
+        start = g_get_monotonic_time();
+        for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+            for (int i = 0; i < BENCHMARK_AIRPORTS; i++) {
+                columns[i] = i;
+            }
+            g_qsort_with_data(columns, BENCHMARK_AIRPORTS, sizeof(int), compare_benchmark_airports, row);
+            for (int i = 0; i < n; i++) {
+                checksum -= (long) (i + 1) * columns[i];
+            }
+        }
+        gint64 sort_time = g_get_monotonic_time() - start;
+        // the checksum is 0 if the heap and the sort select the same airports in the same order
+        printf("  N = %-5d %-6s %10.3fms  %-6s %10.3fms  (checksum %ld)\n", n, "heap", heap_time / 1000.0 / BENCHMARK_ROUNDS, "sort", sort_time / 1000.0 / BENCHMARK_ROUNDS, checksum);
+    }
+    g_free(row);
+    g_free(columns);
+}
+
+#define BENCHMARK_DELAYS (1 << 20) // number of delays of the median benchmark
+
+/**
+ * @brief Compares two delays (for qsort).
+ *
+ * @param a A pointer to the first delay.
+ * @param b A pointer to the second delay.
+ * @return int The comparator (< 0 if a < b).
+ */
+static int compare_benchmark_delays(const void *a, const void *b) {
+    int delay_a = *(const int *) a;
+    int delay_b = *(const int *) b;
+    return (delay_a > delay_b) - (delay_a < delay_b);
+}
+
+/**
+ * @brief Measures the median (and the p90 and p99) of many delays (like query 7) with a selection and with a sort of all the delays.
+ *      The delays are generated (up to a day, with many ties).
+ *
+ * @param datasetDir The directory of the dataset (not used, the delays are generated).
+ */
+static void benchmark_median(const char *datasetDir) {
+    (void) datasetDir;
+    int *generated = g_new(int, BENCHMARK_DELAYS);
+    int *delays = g_new(int, BENCHMARK_DELAYS);
+    guint32 seed = 54321;
+    for (int i = 0; i < BENCHMARK_DELAYS; i++) {
+        seed = seed * 1103515245 + 12345;
+        generated[i] = (int) ((seed >> 8) % (24 * 60 * 60));
+    }
+    printf("Median of %d delays\n", BENCHMARK_DELAYS);
+    int median = 0, p90 = 0, p99 = 0, sorted_median = 0;
+    gint64 select_time = 0, percentiles_time = 0, sort_time = 0;
+    for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+        memcpy(delays, generated, BENCHMARK_DELAYS * sizeof(int));
+        gint64 start = g_get_monotonic_time();
+        median = median_delay(delays, BENCHMARK_DELAYS);
+        select_time += g_get_monotonic_time() - start;
+        start = g_get_monotonic_time();
+        p90 = percentile_delay(delays, BENCHMARK_DELAYS, 90);
+        p99 = percentile_delay(delays, BENCHMARK_DELAYS, 99);
+        percentiles_time += g_get_monotonic_time() - start;
+        memcpy(delays, generated, BENCHMARK_DELAYS * sizeof(int));
+        start = g_get_monotonic_time();
+        qsort(delays, BENCHMARK_DELAYS, sizeof(int), compare_benchmark_delays);
+        sorted_median = (delays[BENCHMARK_DELAYS / 2 - 1] + delays[BENCHMARK_DELAYS / 2]) / 2;
+        sort_time += g_get_monotonic_time() - start;
+    }
+    printf("  %-12s %10.3fms (median %d)\n", "select", select_time / 1000.0 / BENCHMARK_ROUNDS, median);
+    printf("  %-12s %10.3fms (p90 %d, p99 %d)\n", "p90 + p99", percentiles_time / 1000.0 / BENCHMARK_ROUNDS, p90, p99);
+    printf("  %-12s %10.3fms (median %d)\n", "sort", sort_time / 1000.0 / BENCHMARK_ROUNDS, sorted_median);
+    g_free(generated);
+    g_free(delays);
+}
+
+#define BENCHMARK_REVENUE_WINDOWS 20 // number of windows of the hotel revenue benchmark, for each hotel
+
+/**
+ * @brief Gets the revenue of a hotel in a window of days night by night, going through all its reservations (the reference of query 8).
+ *
+ * @param entry The hotel, with its reservations.
+ * @param first_day The first day of the window (@see calculate_day_number).
+ * @param last_day The last day of the window (its night is included).
+ * @return long long The revenue.
+ */
+static long long scan_hotel_revenue(HOTEL_RESERVATIONS *entry, int first_day, int last_day) {
+    long long revenue = 0;
+    for (int i = 0; i < entry->total_reservations; i++) {
+        RESERVATION *reservation = entry->reservations[i];
+        int begin = calculate_day_number(reservation->begin_date);
+        int end = calculate_day_number(reservation->end_date);
+        // the nights from begin_date to the day before end_date
+        for (int day = begin; day < end; day++) {
+            if (day >= first_day && day <= last_day) {
+                revenue += reservation->price_per_night;
+            }
+        }
+    }
+    return revenue;
+}
+
+/**
+ * @brief Measures the revenue of the hotels in windows of days (like query 8) with the prefix sums of the catalog and with a scan of
+ *      the reservations night by night, and checks that both give the same revenue.
+ *      The windows are generated around the reservations of each hotel (partial overlaps, empty windows and windows across months).
+ *
+ * @param datasetDir The directory of the dataset.
+ */
+static void benchmark_hotel_revenue(const char *datasetDir) {
+    char *outputDir = g_dir_make_tmp("benchmark-XXXXXX", NULL);
+    if (outputDir == NULL) {
+        perror("Error creating temporary directory");
+        return;
+    }
+    CATALOG *c = newCatalog(NULL, NULL, NULL, NULL);
+    load_catalog(c, datasetDir, outputDir, NULL);
+    guint32 seed = 24680;
+    long windows = 0, mismatches = 0;
+    gint64 prefix_time = 0, scan_time = 0;
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, c->hotel_reservations);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        HOTEL_RESERVATIONS *entry = value;
+        for (int i = 0; i < BENCHMARK_REVENUE_WINDOWS; i++) {
+            seed = seed * 1103515245 + 12345;
+            RESERVATION *reservation = entry->reservations[(seed >> 8) % entry->total_reservations];
+            seed = seed * 1103515245 + 12345;
+            int first_day = calculate_day_number(reservation->begin_date) + (int) ((seed >> 8) % 81) - 40;
+            seed = seed * 1103515245 + 12345;
+            int last_day = first_day + (int) ((seed >> 8) % 404) - 3;
+            long long prefix = 0;
+            gint64 start = g_get_monotonic_time();
+            if (first_day <= last_day) {
+                prefix = hotel_revenue_before(&entry->revenue, last_day + 1) - hotel_revenue_before(&entry->revenue, first_day);
+            }
+            prefix_time += g_get_monotonic_time() - start;
+            start = g_get_monotonic_time();
+            long long scan = scan_hotel_revenue(entry, first_day, last_day);
+            scan_time += g_get_monotonic_time() - start;
+            mismatches += prefix != scan;
+            windows++;
+        }
+    }
+    printf("Hotel revenue (%ld windows, %u hotels)\n", windows, g_hash_table_size(c->hotel_reservations));
+    if (windows > 0) {
+        printf("  %-12s %10.3fus per window\n", "prefix sums", (double) prefix_time / windows);
+        printf("  %-12s %10.3fus per window (%ld mismatches)\n", "scan", (double) scan_time / windows, mismatches);
+    }
+    free_catalog(c);
+    remove_benchmark_output(outputDir);
+}
+
+/**
+ * @brief Runs all the microbenchmarks over the files of a dataset and prints the results.
+ *
+ * @param datasetDir The directory of the dataset.
+ */
+void run_benchmarks(const char *datasetDir) {
+    benchmark_field_scanners(datasetDir);
+    benchmark_date_validation(datasetDir);
+    benchmark_catalog_memory(datasetDir);
+    benchmark_error_registery(datasetDir);
+    benchmark_snapshot(datasetDir);
+    benchmark_user_flights(datasetDir);
+    benchmark_top_n(datasetDir);
+    benchmark_median(datasetDir);
+    benchmark_hotel_revenue(datasetDir);
+}
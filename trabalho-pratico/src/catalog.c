@@ -6,6 +6,7 @@
 #include "structs.h"
 #include "validation.h"
 #include "parser.h"
+#include "utils.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -38,10 +39,24 @@ void print_catalog(CATALOG *c) {
  */
 void free_catalog(CATALOG *c) {
     if (c != NULL) {
-        g_hash_table_destroy(c->users);
-        g_hash_table_destroy(c->passengers);
-        g_hash_table_destroy(c->flights);
-        g_hash_table_destroy(c->reservations);
+        // the hash tables are NULL if no dataset was loaded
+        if (c->users != NULL) {
+            g_hash_table_destroy(c->users);
+            g_hash_table_destroy(c->passengers);
+            g_hash_table_destroy(c->flights);
+            g_hash_table_destroy(c->reservations);
+            g_hash_table_destroy(c->user_reservations);
+            g_hash_table_destroy(c->hotel_reservations);
+            g_hash_table_destroy(c->origin_flights);
+            // the rest of the flights and airports indexes is in the arenas
+            g_hash_table_destroy(c->user_flights->rows);
+            g_hash_table_destroy(c->airport_passengers->years);
+            g_hash_table_destroy(c->metrics->years);
+        }
+        // the records (allocated in the arenas) point into the mapped files, so both are only freed after the hash tables are destroyed
+        g_ptr_array_free(c->arenas, TRUE);
+        free_string_pool(c->strings);
+        g_ptr_array_free(c->sources, TRUE);
         g_free(c);
     }
 }
@@ -61,5 +76,96 @@ CATALOG *newCatalog(GHashTable *users, GHashTable *passengers, GHashTable *fligh
     c->passengers = passengers;
     c->flights = flights;
     c->reservations = reservations;
+    c->user_reservations = NULL;
+    c->hotel_reservations = NULL;
+    c->origin_flights = NULL;
+    c->user_names = NULL;
+    c->airport_passengers = NULL;
+    c->metrics = NULL;
+    c->user_flights = NULL;
+    c->sources = g_ptr_array_new_with_free_func((GDestroyNotify) close_mapped_dataset);
+    c->arenas = g_ptr_array_new_with_free_func((GDestroyNotify) free_arena);
+    c->strings = new_string_pool();
     return c;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Gives the ownership of a mapped dataset file to the catalog (it is unmapped when the catalog is freed).
+ * 
+ * @param c The catalog.
+ * @param file The mapped file the catalog records point into. @see open_mapped_dataset
+ */
+void add_catalog_source(CATALOG *c, MAPPED_FILE *file) {
+    g_ptr_array_add(c->sources, file);
+}
+
+/**
+ * @brief Gives the ownership of an arena to the catalog (it is freed, with all the records allocated in it, when the catalog is freed).
+ * 
+ * @param c The catalog.
+ * @param arena The arena where catalog records were allocated. @see new_arena
+ */
+void add_catalog_arena(CATALOG *c, ARENA *arena) {
+    g_ptr_array_add(c->arenas, arena);
+}
+
+/**
+ * @brief Gets the reservations of a user (from the index built when the reservations are parsed).
+ * 
+ * @param c The catalog.
+ * @param user_id The user id.
+ * @return USER_RESERVATIONS* The reservations of the user or NULL if the user has no reservations. @see struct USER_RESERVATIONS
+ */
+USER_RESERVATIONS *get_catalog_user_reservations(CATALOG *c, const char *user_id) {
+    return g_hash_table_lookup(c->user_reservations, user_id);
+}
+
+/**
+ * @brief Gets the reservations of a hotel (from the index built when the dataset is loaded).
+ * 
+ * @param c The catalog.
+ * @param hotel_id The hotel id (it does not need to be interned).
+ * @return HOTEL_RESERVATIONS* The reservations of the hotel (sorted by begin_date, most recent first, and id) or NULL if the hotel has no reservations. @see struct HOTEL_RESERVATIONS
+ */
+HOTEL_RESERVATIONS *get_catalog_hotel_reservations(CATALOG *c, const char *hotel_id) {
+    // the index is keyed by the interned hotel ids (if the hotel id was not interned, no reservation has it)
+    char *interned = find_interned_string(c->strings, hotel_id);
+    if (interned == NULL) {
+        return NULL;
+    }
+    return g_hash_table_lookup(c->hotel_reservations, interned);
+}
+
+/**
+ * @brief Gets the flights that depart from an airport (from the index built when the dataset is loaded).
+ * 
+ * @param c The catalog.
+ * @param airport The airport (in any case).
+ * @return AIRPORT_FLIGHTS* The flights of the airport (sorted by schedule_departure_date, most recent first, and id) or NULL if no flight departs from it. @see struct AIRPORT_FLIGHTS
+ */
+AIRPORT_FLIGHTS *get_catalog_origin_flights(CATALOG *c, const char *airport) {
+    char *airport_upper = toupper_str(airport);
+    AIRPORT_FLIGHTS *origin_flights = g_hash_table_lookup(c->origin_flights, airport_upper);
+    g_free(airport_upper);
+    return origin_flights;
+}
+
+/**
+ * @brief Gets the flights of a user (from the index built when the passengers are parsed). @see struct USER_FLIGHTS
+ * 
+ * @param c The catalog.
+ * @param user_id The user id.
+ * @param count Where the number of flights of the user is saved (a flight is counted once per seat of the user).
+ * @return FLIGHT** The flights of the user (count flights, owned by the catalog) or NULL if the user has no flights.
+ */
+FLIGHT **get_catalog_user_flights(CATALOG *c, const char *user_id, int *count) {
+    guint row = GPOINTER_TO_UINT(g_hash_table_lookup(c->user_flights->rows, user_id));
+    if (row == 0) {
+        *count = 0;
+        return NULL;
+    }
+    // rows are saved plus one (0 is a missing user)
+    guint start = c->user_flights->offsets[row - 1];
+    *count = (int) (c->user_flights->offsets[row] - start);
+    return c->user_flights->flights + start;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file fieldScanner.c
+ * @brief Implementation of the CSV field scanner (splits a record by ';' until its '\n', in place).
+ */
+#include "fieldScanner.h"
+
+#include <stddef.h>
+#include <glib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HAS_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Handles a delimiter found by the scanners.
+ *      A ';' ends the current field, a '\n' ends the record. Like g_strsplit, the ';' after the last expected field
+ *      ends it too and the extra fields are ignored (fields_count becomes max_fields + 1 to remember the cut).
+ *
+ * @param delimiter The position of the ';' or '\n'.
+ * @param fields The fields of the record.
+ * @param max_fields The number of fields expected.
+ * @param fields_count The number of fields found so far (updated).
+ * @return int 1 if the record ended (the delimiter was a '\n'), 0 otherwise.
+ */
+static inline int handle_delimiter(char *delimiter, char **fields, int max_fields, int *fields_count) {
+    if (*delimiter == '\n') {
+        *delimiter = '\0';
+        return 1;
+    }
+    if (*fields_count < max_fields) {
+        *delimiter = '\0';
+        fields[(*fields_count)++] = delimiter + 1;
+    } else if (*fields_count == max_fields) {
+        // end of the last expected field, the rest of the record is ignored
+        *delimiter = '\0';
+        (*fields_count)++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Scalar scanner (one byte at a time).
+ *
+ * @param p Where to start scanning.
+ * @param end The end of the readable area.
+ * @param fields The fields of the record.
+ * @param max_fields The number of fields expected.
+ * @param fields_count The number of fields found so far (updated).
+ * @return char* The start of the next record (or end if there are no more records).
+ */
+static char *scan_scalar(char *p, char *end, char **fields, int max_fields, int *fields_count) {
+    for (; p < end; p++) {
+        if ((*p == ';' || *p == '\n') && handle_delimiter(p, fields, max_fields, fields_count)) {
+            return p + 1;
+        }
+    }
+    return end;
+}
+
+#ifdef HAS_X86_SIMD
+/**
+ * @brief SSE2 scanner (16 bytes at a time, the tail is scanned by the scalar scanner).
+ *      Only whole blocks inside [p, end) are loaded, so it never reads bytes of another chunk. @see scan_scalar
+ */
+__attribute__((target("sse2")))
+static char *scan_sse2(char *p, char *end, char **fields, int max_fields, int *fields_count) {
+    const __m128i semicolon = _mm_set1_epi8(';');
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *) p);
+        unsigned int mask = (unsigned int) _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, semicolon), _mm_cmpeq_epi8(block, newline)));
+        while (mask != 0) {
+            char *delimiter = p + __builtin_ctz(mask);
+            mask &= mask - 1;
+            if (handle_delimiter(delimiter, fields, max_fields, fields_count)) {
+                return delimiter + 1;
+            }
+        }
+        p += 16;
+    }
+    return scan_scalar(p, end, fields, max_fields, fields_count);
+}
+
+/**
+ * @brief AVX2 scanner (32 bytes at a time, the tail is scanned by the scalar scanner). @see scan_sse2
+ */
+__attribute__((target("avx2")))
+static char *scan_avx2(char *p, char *end, char **fields, int max_fields, int *fields_count) {
+    const __m256i semicolon = _mm256_set1_epi8(';');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    while (end - p >= 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *) p);
+        unsigned int mask = (unsigned int) _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, semicolon), _mm256_cmpeq_epi8(block, newline)));
+        while (mask != 0) {
+            char *delimiter = p + __builtin_ctz(mask);
+            mask &= mask - 1;
+            if (handle_delimiter(delimiter, fields, max_fields, fields_count)) {
+                return delimiter + 1;
+            }
+        }
+        p += 32;
+    }
+    return scan_scalar(p, end, fields, max_fields, fields_count);
+}
+#endif
+
+// a scanner implementation (scans from p until the end of the record, @see scan_scalar)
+typedef char *(*SCAN_FUNCTION)(char *p, char *end, char **fields, int max_fields, int *fields_count);
+
+static FIELD_SCANNER best_scanner = SCANNER_SCALAR;
+static SCAN_FUNCTION scan_functions[SCANNER_AVX2 + 1]; // the implementation used by each scanner (the scalar one if it is not supported)
+
+/**
+ * @brief Checks the processor features once and chooses the implementation of each scanner and the best scanner.
+ */
+static void init_scanners(void) {
+    static gsize initialized = 0;
+    if (g_once_init_enter(&initialized)) {
+        scan_functions[SCANNER_SCALAR] = scan_scalar;
+        scan_functions[SCANNER_SSE2] = scan_scalar;
+        scan_functions[SCANNER_AVX2] = scan_scalar;
+#ifdef HAS_X86_SIMD
+        if (__builtin_cpu_supports("sse2")) {
+            scan_functions[SCANNER_SSE2] = scan_sse2;
+            scan_functions[SCANNER_AVX2] = scan_sse2;
+            best_scanner = SCANNER_SSE2;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            scan_functions[SCANNER_AVX2] = scan_avx2;
+            best_scanner = SCANNER_AVX2;
+        }
+#endif
+        g_once_init_leave(&initialized, 1);
+    }
+}
+
+/**
+ * @brief Gets the fastest scanner supported by the processor.
+ *
+ * @return FIELD_SCANNER The scanner.
+ */
+FIELD_SCANNER best_field_scanner(void) {
+    init_scanners();
+    return best_scanner;
+}
+
+/**
+ * @brief Gets the name of a scanner.
+ *
+ * @param scanner The scanner.
+ * @return const char* The name of the scanner.
+ */
+const char *field_scanner_name(FIELD_SCANNER scanner) {
+    switch (scanner) {
+        case SCANNER_AVX2:
+            return "avx2";
+        case SCANNER_SSE2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
+
+/**
+ * @brief Splits a record with a scanner implementation. @see scan_fields
+ *
+ * @param scan The scanner implementation.
+ * @param line The start of the record.
+ * @param end The end of the readable area.
+ * @param fields The array where the fields are saved (must have space for max_fields).
+ * @param max_fields The number of fields expected.
+ * @param fields_count Where the number of fields found in the record is saved.
+ * @return char* The start of the next record (or end if there are no more records).
+ */
+static inline char *split_record(SCAN_FUNCTION scan, char *line, char *end, char **fields, int max_fields, int *fields_count) {
+    fields[0] = line;
+    *fields_count = 1;
+    char *next = scan(line, end, fields, max_fields, fields_count);
+    // missing fields are empty
+    for (int i = *fields_count; i < max_fields; i++) {
+        fields[i] = (char *) "";
+    }
+    return next;
+}
+
+/**
+ * @brief Splits the record that starts at line using a specific scanner. @see scan_fields
+ *      If the scanner is not supported by the processor the best supported one is used.
+ *
+ * @param scanner The scanner.
+ * @param line The start of the record.
+ * @param end The end of the readable area (the record ends at the first '\n' or here, where there must be a '\0').
+ * @param fields The array where the fields are saved (must have space for max_fields).
+ * @param max_fields The number of fields expected.
+ * @param fields_count Where the number of fields found in the record is saved (use it to restore the line, @see restore_line).
+ * @return char* The start of the next record (or end if there are no more records).
+ */
+char *scan_fields_using(FIELD_SCANNER scanner, char *line, char *end, char **fields, int max_fields, int *fields_count) {
+    init_scanners();
+    return split_record(scan_functions[scanner], line, end, fields, max_fields, fields_count);
+}
+
+/**
+ * @brief Splits the record that starts at line by ';' (each ';' is replaced by '\0') and ends it at its '\n' (replaced by '\0'),
+ *      using the fastest scanner supported by the processor (chosen once, @see init_scanners).
+ *      If the record has less fields than max_fields, the missing fields are set to an empty string;
+ *      if it has more, they are ignored (like the fields after max_fields of g_strsplit) and fields_count is max_fields + 1.
+ *
+ * @param line The start of the record (it is modified).
+ * @param end The end of the readable area (the record ends at the first '\n' or here, where there must be a '\0').
+ * @param fields The array where the fields are saved (must have space for max_fields).
+ * @param max_fields The number of fields expected.
+ * @param fields_count Where the number of fields found in the record is saved (use it to restore the line, @see restore_line).
+ * @return char* The start of the next record (or end if there are no more records).
+ */
+char *scan_fields(char *line, char *end, char **fields, int max_fields, int *fields_count) {
+    init_scanners();
+    return split_record(scan_functions[best_scanner], line, end, fields, max_fields, fields_count);
+}
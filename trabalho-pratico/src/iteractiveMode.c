@@ -5,6 +5,8 @@
 #include "iteractiveMode.h"
 #include "interpreter.h"
 #include "parser.h"
+#include "loader.h"
+#include "snapshot.h"
 #include "queries.h"
 
 #include <stdio.h>
@@ -12,7 +14,7 @@
 #include <ncurses.h> // importa ncurses
 
 APPSTATUS *appStatus;
-GList *result; // List to store the result of a query
+RESULT_BUFFER *result; // the result of the last query (NULL until the first query)
 
 #define DEFAULT_OUTPUT_DIR "Resultados/"
 #define NUM_QUERIES 10
@@ -77,14 +79,15 @@ void showLoadingScreen() {
 void loadDataset(char *path, CATALOG *c) {
 	appStatus->isLoading = 1;
 	showLoadingScreen();
-	GHashTable *users = parse_users(path, DEFAULT_OUTPUT_DIR);
-	GHashTable *reservations = parse_reservations(path, DEFAULT_OUTPUT_DIR, users);
-	GHashTable *flights = parse_flights(path, DEFAULT_OUTPUT_DIR);
-	GHashTable *passengers = parse_passengers(path, DEFAULT_OUTPUT_DIR, users, flights);
-	c->users = users;
-	c->reservations = reservations;
-	c->flights = flights;
-	c->passengers = passengers;
+	// the path can be a dataset directory or a snapshot file (@see save_snapshot)
+	if (is_snapshot_path(path)) {
+		if (!load_snapshot(c, path)) {
+			endwin();
+			exit(EXIT_FAILURE);
+		}
+	} else {
+		load_catalog(c, path, DEFAULT_OUTPUT_DIR, NULL);
+	}
 	appStatus->isLoading = 0;
 	appStatus->isDatasetLoaded = 1;
 }
@@ -272,62 +275,38 @@ char* askForQArgs(int query_id) {
 	return command;
 }
 
-void print_result(GList *result, int page_size, int *pages) {
-	GHashTable *paginated_result = g_hash_table_new(g_str_hash, g_str_equal);
-	int current_page = 1; // this is not used as pagination, its used as key to split n lines in the page
+void print_result(RESULT_BUFFER *result, int page_size, int *pages) {
+	int current_page = 1;
 	int lines_in_page = 0;
-	int current_line = 0;
-	for (GList *l = result; l != NULL; l = l->next) {
-		char *line = (char *) l->data;
-		int line_len = strlen(line);
+	for (int i = 0; i < result_buffer_size(result); i++) {
+		gsize line_len = 0;
+		const char *line = result_buffer_line(result, i, &line_len);
 		// if line is empty we dont need to count it
-		if (line_len == 0 || strcmp(line, "") == 0 || strcmp(line, "\n") == 0 || strcmp(line, "\0") == 0) {
+		if (line_len == 0 || (line_len == 1 && line[0] == '\n')) {
 			continue;
 		}
 		int line_lines = 1;
-		for (int j = 0; j < line_len; j++) {
+		for (gsize j = 0; j < line_len; j++) {
 			if (line[j] == '\n') {
 				line_lines++;
 			}
 		}
-		// now check if line_lines+1 (the '\n's in a line and the line itself) fits in the page
-		if (lines_in_page + line_lines > page_size) {
-			// it doesnt fit in the page, so we increment the current page and add the rest to the saved lines
+		// now check if line_lines+1 (the '\n's in a line and the line itself) fits in the page, if it doesnt it starts the next page
+		if (lines_in_page > 0 && lines_in_page + line_lines > page_size) {
 			current_page++;
-			lines_in_page = line_lines;
-		} else {
-			// it fits in the page, so we can print it and add the lines to the lines in page
-			lines_in_page += line_lines;
-			// we can add the line to the hash table
-			// if current_page is not in the hash table, we need to create a new key, if it is we concatenate the line to the value
-			char* key = g_strdup_printf("%d", current_page);
-			char* value = (char *) g_hash_table_lookup(paginated_result, key);
-			if (value == NULL) {
-				// the key doesnt exist, so we create a new key with the line
-				g_hash_table_insert(paginated_result, key, line);
-			} else {
-				// the key exists, so we concatenate the line to the value
-				char *new_value = g_strdup_printf("%s%s", value, line);
-				g_hash_table_insert(paginated_result, key, new_value);
-			}
+			lines_in_page = 0;
 		}
-		current_line++;
-	}
-	// in the end as we have all pages completed, the total number of pages is the number of keys in the hash table
-	*pages = current_page;
-	// now we can print the lines
-	for (GList *l = g_hash_table_get_keys(paginated_result); l != NULL; l = l->next) {
-		char *key = (char *) l->data;
-		if (atoi(key) == appStatus->page) {
-			char *value = (char *) g_hash_table_lookup(paginated_result, key);
-			printw("%s", value);
+		lines_in_page += line_lines;
+		// only the lines of the page being shown are printed
+		if (current_page == appStatus->page) {
+			printw("%.*s", (int) line_len, line);
 		}
 	}
-	// free memory
-	g_hash_table_destroy(paginated_result);
+	// in the end as we have all pages completed, the total number of pages is the number of the last page
+	*pages = current_page;
 }
 
-void showQResult(GList *result) {
+void showQResult(RESULT_BUFFER *result) {
 	appStatus->isInPagination = 1;
 	clear();
 	attron(COLOR_PAIR(COLOR_GREEN));
@@ -372,8 +351,7 @@ void execute_query(CATALOG *c, int query) {
 	char *command = askForQArgs(query);
 	//printw("Command: %s\n", command);
 	// we cant write the query results to a file because it crashes ncruses
-	// so we will create a list that stores every line of the result (maybe we can use a queue instead of a list)
-	//GList *result = NULL; // making this a global variable for now
+	// so the lines of the result are kept in a result buffer (a global variable, to be shown again when the page changes)
 	char* result_command[3];
 	command_interpreter(command, result_command);
 	/*printf("Query ID: %s\n", result_command[0]);
@@ -428,68 +406,59 @@ void execute_query(CATALOG *c, int query) {
             }
         }
     }
+	// the result buffer is reused by all the queries
+	if (result == NULL) {
+		result = new_result_buffer();
+	} else {
+		clear_result_buffer(result);
+	}
 	// execute queries
 	switch (query_id) {
 		case 1:
 			char* res_1 = query_1(c, format_flag, args, args_size);
-			result = g_list_append(result, res_1);
+			result_buffer_append(result, res_1);
+			g_free(res_1);
 			break;
 		case 2:
-			GList *res_2 = NULL;
-            query_2(c, format_flag, args, args_size, &res_2);
-			result = res_2;
+			query_2(c, format_flag, args, args_size, result);
 			break;
 		case 3:
 			char* res_3 = query_1(c, format_flag, args, args_size);
-			result = g_list_append(result, res_3);
+			result_buffer_append(result, res_3);
+			g_free(res_3);
 			break;
 		case 4:
-			GList *res_4 = NULL;
-			query_4(c, format_flag, args, args_size, &res_4);
-			result = res_4;
+			query_4(c, format_flag, args, args_size, result);
 			break;
 		case 5:
-			GList *res_5 = NULL;
-			query_5(c, format_flag, args, args_size, &res_5);
-			result = res_5;
+			query_5(c, format_flag, args, args_size, result);
 			break;
 		case 6:
-			GList *res_6 = NULL;
-			query_6(c, format_flag, args, args_size, &res_6);
-			result = res_6;
+			query_6(c, format_flag, args, args_size, result);
 			break;
 		case 7:
-			GList *res_7 = NULL;
-			query_7(c, format_flag, args, args_size, &res_7);
-			result = res_7;
+			query_7(c, format_flag, args, args_size, result);
 			break;
 		case 8:
 			char* res_8 = query_8(c, format_flag, args, args_size);
-			result = g_list_append(result, res_8);
+			result_buffer_append(result, res_8);
+			g_free(res_8);
 			break;
 		case 9:
-			GList *res_9 = NULL;
-			query_9(c, format_flag, args, args_size, &res_9);
-			result = res_9;
+			query_9(c, format_flag, args, args_size, result);
 			break;
 		case 10:
-			GList *res_10 = NULL;
-			query_10(c, format_flag, args, args_size, &res_10);
-			result = res_10;
+			query_10(c, format_flag, args, args_size, result);
 			break;
 		default:
 			printw("Query ID inválido!\n");
 			break;
 	}
 	// print results
-	if (result != NULL) {
-		// if the result is empty we dont print anything
-		if (g_list_length(result) <= 1 && (strcmp((char *) g_list_nth_data(result, 0), "") == 0 || strcmp((char *) g_list_nth_data(result, 0), "\n") == 0 || strcmp((char *) g_list_nth_data(result, 0), "\0") == 0)) {
-			// add a string to the list to print
-			result = g_list_append(result, "A query não retornou resultados!");
-		}
-	} else {
-		result = g_list_append(result, "A query não retornou resultados!");
+	// if the result is empty we dont print anything
+	if (result->text->len == 0 || strcmp(result->text->str, "\n") == 0) {
+		// add a string to the result to print
+		result_buffer_append(result, "A query não retornou resultados!");
 	}
 	// lets create a new page to print the results (with pagination)
 	showQResult(result);
@@ -546,7 +515,7 @@ void iteractiveMode() {
 			appStatus->isInPagination = 0;
 			// for pagination we need to reset the page and result
 			appStatus->page = 1;
-			result = NULL;
+			clear_result_buffer(result);
 			execute_main_app(c);
 		} else if (appStatus->isInTitleScreen) {
 			clear();
@@ -0,0 +1,62 @@
+/**
+ * @file lineReader.c
+ * @brief Implementation of the line reader (lines of any length read from a stream).
+ */
+#include "lineReader.h"
+
+#include <string.h>
+#include <glib.h>
+
+/**
+ * @brief Creates a line reader for a stream (the stream is not closed with the reader).
+ *
+ * @param file The stream to read.
+ * @return LINE_READER* The line reader. @see struct LINE_READER
+ */
+LINE_READER *new_line_reader(FILE *file) {
+    LINE_READER *reader = g_new(LINE_READER, 1);
+    reader->file = file;
+    reader->capacity = LINE_READER_INITIAL_SIZE;
+    reader->buffer = g_malloc(reader->capacity);
+    return reader;
+}
+
+/**
+ * @brief Reads the next line of the stream, whatever its length (the buffer grows until the line fits).
+ *
+ * @param reader The line reader. @see new_line_reader
+ * @param length Where the length of the line is saved (can be NULL).
+ * @return char* The line, with its '\n' (like fgets, the last line may not have it), or NULL at the end of the stream.
+ *      It is only valid until the next line is read.
+ */
+char *read_line(LINE_READER *reader, size_t *length) {
+    if (fgets(reader->buffer, (int) reader->capacity, reader->file) == NULL) {
+        return NULL;
+    }
+    size_t used = strlen(reader->buffer);
+    // the line did not fit, so the buffer is doubled and the rest of the line is read after what was already read
+    while (used == reader->capacity - 1 && reader->buffer[used - 1] != '\n') {
+        reader->capacity *= 2;
+        reader->buffer = g_realloc(reader->buffer, reader->capacity);
+        if (fgets(reader->buffer + used, (int) (reader->capacity - used), reader->file) == NULL) {
+            break;
+        }
+        used += strlen(reader->buffer + used);
+    }
+    if (length != NULL) {
+        *length = used;
+    }
+    return reader->buffer;
+}
+
+/**
+ * @brief Frees a line reader (the stream is not closed).
+ *
+ * @param reader The line reader.
+ */
+void free_line_reader(LINE_READER *reader) {
+    if (reader != NULL) {
+        g_free(reader->buffer);
+        g_free(reader);
+    }
+}
@@ -0,0 +1,182 @@
+/**
+ * @file loader.c
+ * @brief Implementation of the dataset loader (parses the datasets in parallel, following their dependencies).
+ */
+#include "loader.h"
+#include "parser.h"
+#include "mappedFile.h"
+#include "statistics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+
+typedef struct parser_task {
+    const char *datasetDir;
+    const char *outputDir;
+    GHashTable *users; // input of the reservations and passengers parsers
+    GHashTable *flights; // input of the passengers parser
+    GHashTable *result; // parsed hash table
+    GHashTable *index; // index built by the reservations parser (the reservations by user)
+    USER_FLIGHTS *user_flights; // index built by the passengers parser (the flights by user)
+    ARENA *arena; // arena where the parsed records are allocated (each parser has its own)
+    STRING_POOL *strings; // string pool where the parsed records strings are interned (each parser has its own)
+    MAPPED_FILE *source; // mapped file the parsed records point into
+    LOAD_STAGE_TIME *time;
+} PARSER_TASK;
+
+/**
+ * @brief Thread function that parses the users dataset. @see parse_users
+ *
+ * @param data The parser task. @see struct PARSER_TASK
+ * @return gpointer NULL (the result is saved in the task).
+ */
+static gpointer users_task(gpointer data) {
+    PARSER_TASK *task = (PARSER_TASK *) data;
+    task->time->start = g_get_monotonic_time();
+    task->result = parse_users(task->datasetDir, task->outputDir, task->arena, task->strings, &task->source);
+    task->time->end = g_get_monotonic_time();
+    return NULL;
+}
+
+/**
+ * @brief Thread function that parses the reservations dataset (the users must be already parsed). @see parse_reservations
+ *
+ * @param data The parser task. @see struct PARSER_TASK
+ * @return gpointer NULL (the result is saved in the task).
+ */
+static gpointer reservations_task(gpointer data) {
+    PARSER_TASK *task = (PARSER_TASK *) data;
+    task->time->start = g_get_monotonic_time();
+    task->result = parse_reservations(task->datasetDir, task->outputDir, task->users, task->arena, task->strings, &task->index, &task->source);
+    task->time->end = g_get_monotonic_time();
+    return NULL;
+}
+
+/**
+ * @brief Thread function that parses the flights dataset. @see parse_flights
+ *
+ * @param data The parser task. @see struct PARSER_TASK
+ * @return gpointer NULL (the result is saved in the task).
+ */
+static gpointer flights_task(gpointer data) {
+    PARSER_TASK *task = (PARSER_TASK *) data;
+    task->time->start = g_get_monotonic_time();
+    task->result = parse_flights(task->datasetDir, task->outputDir, task->arena, task->strings, &task->source);
+    task->time->end = g_get_monotonic_time();
+    return NULL;
+}
+
+/**
+ * @brief Thread function that parses the passengers dataset (the users and flights must be already parsed). @see parse_passengers
+ *
+ * @param data The parser task. @see struct PARSER_TASK
+ * @return gpointer NULL (the result is saved in the task).
+ */
+static gpointer passengers_task(gpointer data) {
+    PARSER_TASK *task = (PARSER_TASK *) data;
+    task->time->start = g_get_monotonic_time();
+    task->result = parse_passengers(task->datasetDir, task->outputDir, task->users, task->flights, task->arena, &task->user_flights, &task->source);
+    task->time->end = g_get_monotonic_time();
+    return NULL;
+}
+
+/**
+ * @brief Loads a dataset into a catalog, running the parsers in parallel.
+ *      Users and flights are parsed concurrently, reservations starts as soon as the users are parsed
+ *      and passengers as soon as the users and the flights are parsed (the parsed hash tables are only read by the other parsers).
+ *
+ * @param c The catalog where the hash tables (and the mapped files, arenas and interned strings) are saved. @see newCatalog
+ * @param datasetDir The directory of the dataset.
+ * @param outputDir The directory of the output (errors files).
+ * @param times Where the wall clock time of each stage is saved (can be NULL). @see struct LOAD_TIMES
+ */
+void load_catalog(CATALOG *c, const char *datasetDir, const char *outputDir, LOAD_TIMES *times) {
+    LOAD_TIMES local_times;
+    if (times == NULL) {
+        times = &local_times;
+    }
+    times->total.start = g_get_monotonic_time();
+
+    PARSER_TASK users = { datasetDir, outputDir, NULL, NULL, NULL, NULL, NULL, new_arena(), new_string_pool(), NULL, &times->users };
+    PARSER_TASK flights = { datasetDir, outputDir, NULL, NULL, NULL, NULL, NULL, new_arena(), new_string_pool(), NULL, &times->flights };
+    GThread *users_thread = g_thread_new("users", users_task, &users);
+    GThread *flights_thread = g_thread_new("flights", flights_task, &flights);
+
+    g_thread_join(users_thread);
+    PARSER_TASK reservations = { datasetDir, outputDir, users.result, NULL, NULL, NULL, NULL, new_arena(), new_string_pool(), NULL, &times->reservations };
+    GThread *reservations_thread = g_thread_new("reservations", reservations_task, &reservations);
+
+    g_thread_join(flights_thread);
+    PARSER_TASK passengers = { datasetDir, outputDir, users.result, flights.result, NULL, NULL, NULL, new_arena(), NULL, NULL, &times->passengers };
+    GThread *passengers_thread = g_thread_new("passengers", passengers_task, &passengers);
+
+    g_thread_join(reservations_thread);
+    g_thread_join(passengers_thread);
+
+    c->users = users.result;
+    c->reservations = reservations.result;
+    c->user_reservations = reservations.index;
+    c->flights = flights.result;
+    c->passengers = passengers.result;
+    c->user_flights = passengers.user_flights;
+    add_catalog_source(c, users.source);
+    add_catalog_source(c, reservations.source);
+    add_catalog_source(c, flights.source);
+    add_catalog_source(c, passengers.source);
+    add_catalog_arena(c, users.arena);
+    add_catalog_arena(c, reservations.arena);
+    add_catalog_arena(c, flights.arena);
+    add_catalog_arena(c, passengers.arena);
+
+    // the string pools of the parsers are merged into the catalog pool (a value repeated in two datasets is kept once)
+    GHashTable *remap = merge_string_pools(c->strings, users.strings);
+    remap_users_strings(c->users, remap);
+    if (remap != NULL) {
+        g_hash_table_destroy(remap);
+    }
+    // the users index sets the collation locale, so it is only built when the parsers are done
+    c->user_names = index_user_names(c->users, users.arena);
+    remap = merge_string_pools(c->strings, flights.strings);
+    remap_flights_strings(c->flights, remap);
+    if (remap != NULL) {
+        g_hash_table_destroy(remap);
+    }
+    c->origin_flights = index_origin_flights(c->flights, flights.arena);
+    remap = merge_string_pools(c->strings, reservations.strings);
+    remap_reservations_strings(c->reservations, remap);
+    if (remap != NULL) {
+        g_hash_table_destroy(remap);
+    }
+    // the hotels index is keyed by the interned hotel ids, so it is only built after the merge
+    c->hotel_reservations = index_hotel_reservations(c->reservations, reservations.arena);
+    c->airport_passengers = index_airport_passengers(c->flights, c->passengers, passengers.arena);
+    c->metrics = build_metrics_cube(c, passengers.arena);
+
+    times->total.end = g_get_monotonic_time();
+}
+
+/**
+ * @brief Gets the wall clock duration of a load stage.
+ *
+ * @param stage The stage. @see struct LOAD_STAGE_TIME
+ * @return double The duration in seconds.
+ */
+double load_stage_seconds(LOAD_STAGE_TIME stage) {
+    return (double) (stage.end - stage.start) / G_USEC_PER_SEC;
+}
+
+/**
+ * @brief Prints the wall clock time of each load stage (and when it started, relative to the start of the load).
+ *
+ * @param times The load times. @see load_catalog
+ */
+void print_load_times(LOAD_TIMES *times) {
+    const char *names[] = { "Users", "Reservations", "Flights", "Passengers" };
+    LOAD_STAGE_TIME stages[] = { times->users, times->reservations, times->flights, times->passengers };
+    for (int i = 0; i < 4; i++) {
+        double started = (double) (stages[i].start - times->total.start) / G_USEC_PER_SEC;
+        printf("%s parser executed in time: %fs (wall clock, started at %fs)\n", names[i], load_stage_seconds(stages[i]), started);
+    }
+    printf("Dataset loaded in time: %fs (wall clock)\n", load_stage_seconds(times->total));
+}
@@ -7,7 +7,10 @@
 #include "utils.h"
 #include "parser.h"
 #include "catalog.h"
+#include "loader.h"
 #include "unitTesting.h"
+#include "benchmark.h"
+#include "snapshot.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -24,51 +27,49 @@
  * 
  * @param argc Number of command-line arguments.
  * @param argv Array of command-line argument strings.
- * @return Returns 0 upon successful execution.
+ * @return Returns 0 upon successful execution (with programa-testes, 1 if an output differs from the expected one).
 */
 int main(int argc, char *argv[]) {
 	// start performance testing
 	clock_t start, end;
 	start = clock();
+	int status = 0;
     if (argc > 1) { // Se tivermos argumentos, estamos em modo batch diretamente, programa-teste <caminho para o dataset com os CSVs, o ficheiro com os comandos a executar, e uma pasta com os ficheiros de output esperado>
-		if (argc >= 3 && argc <= 4) {
-			char *datasetDir = argv[1];
-			char *inputFile = argv[2];
-			char *outputDir = argv[3];
+		if (argc == 3 && strcmp(argv[1], "--benchmark") == 0) {
+			run_benchmarks(argv[2]);
+		} else if (argc == 4 && strcmp(argv[1], "--save-snapshot") == 0) {
+			// parse (and validate) the dataset once and save the catalog to a snapshot
+			CATALOG *c = newCatalog(NULL, NULL, NULL, NULL);
+			load_catalog(c, argv[2], OUTPUT_DIR, NULL);
+			save_snapshot(c, argv[3]);
+			free_catalog(c);
+		} else if ((argc >= 3 && argc <= 4 && strcmp(argv[1], "--load-snapshot") != 0) || ((argc == 4 || argc == 5) && strcmp(argv[1], "--load-snapshot") == 0)) {
+			// with --load-snapshot the catalog is loaded from a snapshot instead of the dataset (the other arguments are the same)
+			int fromSnapshot = strcmp(argv[1], "--load-snapshot") == 0;
+			char *datasetDir = argv[1 + fromSnapshot];
+			char *inputFile = argv[2 + fromSnapshot];
+			char *outputDir = argv[3 + fromSnapshot];
 			int runninTests = 0;
 			if (argc >= 3 && strstr(argv[0], "programa-testes") != NULL) { // or: argc > 3 && outputDir != NULL
 				runninTests = 1;
 			}
-			clock_t parser_start, parser_end;
-			parser_start = clock();
-			GHashTable *users = parse_users(datasetDir, OUTPUT_DIR);
-			parser_end = clock();
-			if (runninTests) {
-				double time_taken = ((double)parser_end - parser_start) / CLOCKS_PER_SEC;
-				printf("Users parser executed in time: %fs\n", time_taken);
-			}
-			parser_start = clock();
-			GHashTable *reservations = parse_reservations(datasetDir, OUTPUT_DIR, users);
-			parser_end = clock();
-			if (runninTests) {
-				double time_taken = ((double)parser_end - parser_start) / CLOCKS_PER_SEC;
-				printf("Reservations parser executed in time: %fs\n", time_taken);
-			}
-			parser_start = clock();
-			GHashTable *flights = parse_flights(datasetDir, OUTPUT_DIR);
-			parser_end = clock();
-			if (runninTests) {
-				double time_taken = ((double)parser_end - parser_start) / CLOCKS_PER_SEC;
-				printf("Flights parser executed in time: %fs\n", time_taken);
-			}
-			parser_start = clock();
-			GHashTable *passengers = parse_passengers(datasetDir, OUTPUT_DIR, users, flights);
-			parser_end = clock();
-			if (runninTests) {
-				double time_taken = ((double)parser_end - parser_start) / CLOCKS_PER_SEC;
-				printf("Passengers parser executed in time: %fs\n", time_taken);
+			LOAD_TIMES load_times;
+			CATALOG *c = newCatalog(NULL, NULL, NULL, NULL);
+			if (fromSnapshot) {
+				gint64 load_start = g_get_monotonic_time();
+				if (!load_snapshot(c, datasetDir)) {
+					free_catalog(c);
+					return 1;
+				}
+				if (runninTests) {
+					printf("Snapshot loaded in time: %fs (wall clock)\n", (double) (g_get_monotonic_time() - load_start) / G_USEC_PER_SEC);
+				}
+			} else {
+				load_catalog(c, datasetDir, OUTPUT_DIR, &load_times);
+				if (runninTests) {
+					print_load_times(&load_times);
+				}
 			}
-			CATALOG *c = newCatalog(users, passengers, flights, reservations);
 			batchMode(inputFile, OUTPUT_DIR, c, runninTests);
 			//g_hash_table_foreach(users, print_hash_user, NULL);
 			//printf("Tamanho da hash table users: %u\n", g_hash_table_size(users));
@@ -82,13 +83,18 @@ int main(int argc, char *argv[]) {
 			//g_hash_table_foreach(flights, print_hash_flight, NULL);
 			//printf("Tamanho da hash table flights: %u\n", g_hash_table_size(flights));
 			//free_flights(flights);
-			if (argc > 3 && outputDir != NULL && strstr(argv[0], "programa-testes") != NULL) { // or: argc > 3 && outputDir != NULL
-				run_unit_tests(OUTPUT_DIR, outputDir);
+			if (argc > 3 + fromSnapshot && outputDir != NULL && strstr(argv[0], "programa-testes") != NULL) { // or: argc > 3 && outputDir != NULL
+				if (run_unit_tests(OUTPUT_DIR, outputDir) != 0) {
+					status = 1;
+				}
 			}
 			free_catalog(c);
 		} else {
 			printf("Usage: programa-principal <caminho para o dataset com os CSVs> <ficheiro com os comandos a executar>\n");
 			printf("       programa-testes <caminho para o dataset com os CSVs> <ficheiro com os comandos a executar> <pasta com os ficheiros de output esperado>\n");
+			printf("       programa-testes --benchmark <caminho para o dataset com os CSVs>\n");
+			printf("       programa-principal --save-snapshot <caminho para o dataset com os CSVs> <ficheiro do snapshot>\n");
+			printf("       programa-principal --load-snapshot <ficheiro do snapshot> <ficheiro com os comandos a executar>\n");
 			return 1;
 		}
     } else {
@@ -103,5 +109,5 @@ int main(int argc, char *argv[]) {
 		double cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
 		printf("CPU time used: %f\n", cpu_time_used);
 	}
-    return 0;
+    return status;
 }
\ No newline at end of file
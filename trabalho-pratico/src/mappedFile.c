@@ -0,0 +1,235 @@
+/**
+ * @file mappedFile.c
+ * @brief Implementation of the memory-mapped dataset files (zero-copy CSV ingest).
+ */
+#include "mappedFile.h"
+#include "structs.h"
+#include "fieldScanner.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <glib.h>
+
+/**
+ * @brief Maps a dataset file (e.g. "users.csv") from the dataset directory into memory. @see open_mapped_file
+ *
+ * @param datasetDir The directory of the dataset.
+ * @param datasetName The name of the file inside the dataset directory.
+ * @return MAPPED_FILE* The mapped file. @see struct MAPPED_FILE
+ */
+MAPPED_FILE *open_mapped_dataset(const char *datasetDir, const char *datasetName) {
+    char datasetPath[MAX_PATH_LENGTH];
+    // if datasetDir ends in /, remove it
+    if (datasetDir[strlen(datasetDir) - 1] == '/') {
+        snprintf(datasetPath, MAX_PATH_LENGTH, "%s%s", datasetDir, datasetName);
+    } else {
+        snprintf(datasetPath, MAX_PATH_LENGTH, "%s/%s", datasetDir, datasetName);
+    }
+    return open_mapped_file(datasetPath);
+}
+
+/**
+ * @brief Maps a file into memory.
+ *      The mapping is private (copy-on-write), so the file can be tokenized in place without changing it on disk.
+ *      The mapped contents are always followed by a '\0', even when the file size is a multiple of the page size.
+ *
+ * @param path The path of the file.
+ * @return MAPPED_FILE* The mapped file. @see struct MAPPED_FILE
+ */
+MAPPED_FILE *open_mapped_file(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        perror("Error opening file");
+        exit(EXIT_FAILURE);
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        perror("Error reading file");
+        exit(EXIT_FAILURE);
+    }
+
+    MAPPED_FILE *file = g_new(MAPPED_FILE, 1);
+    file->size = st.st_size;
+    // reserve one extra byte (rounded up to a whole page) so there is always a '\0' after the last line
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    file->map_size = (file->size + 1 + page_size - 1) / page_size * page_size;
+    file->data = mmap(NULL, file->map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (file->data == MAP_FAILED) {
+        perror("Error mapping file");
+        exit(EXIT_FAILURE);
+    }
+    // the file is mapped over the start of the reserved (zero filled) area
+    if (file->size > 0 && mmap(file->data, file->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        perror("Error mapping file");
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+    madvise(file->data, file->size, MADV_WILLNEED);
+    file->cursor = file->data;
+    return file;
+}
+
+/**
+ * @brief Gets the next line of a mapped file. The '\n' at the end of the line is replaced by '\0' (in place).
+ *
+ * @param file The mapped file. @see open_mapped_dataset
+ * @return char* The line (a slice of the mapped file) or NULL if there are no more lines.
+ */
+char *next_mapped_line(MAPPED_FILE *file) {
+    char *end = file->data + file->size;
+    if (file->cursor >= end) {
+        return NULL;
+    }
+    char *line = file->cursor;
+    char *newline = memchr(line, '\n', end - line);
+    if (newline != NULL) {
+        *newline = '\0';
+        file->cursor = newline + 1;
+    } else {
+        // last line without '\n', it is already followed by the '\0' after the mapped file
+        file->cursor = end;
+    }
+    return line;
+}
+
+/**
+ * @brief Gets the next record of a mapped file, split in fields in place. @see scan_fields
+ *
+ * @param file The mapped file. @see open_mapped_dataset
+ * @param fields The array where the fields are saved (must have space for max_fields).
+ * @param max_fields The number of fields expected (missing fields are empty, extra fields are ignored).
+ * @param fields_count Where the number of fields found is saved (use it to restore the line, @see restore_line).
+ * @return char* The line (a slice of the mapped file) or NULL if there are no more lines.
+ */
+char *next_mapped_record(MAPPED_FILE *file, char **fields, int max_fields, int *fields_count) {
+    char *end = file->data + file->size;
+    if (file->cursor >= end) {
+        return NULL;
+    }
+    char *line = file->cursor;
+    file->cursor = scan_fields(line, end, fields, max_fields, fields_count);
+    return line;
+}
+
+/**
+ * @brief Splits the unread part of a mapped file in chunks that end at newline boundaries, so they can be parsed in parallel.
+ *      The number of chunks depends on the number of processors and on the size of the file (small files are a single chunk).
+ *      Reading the chunks in order gives the same lines as reading the file. The file cursor is moved to the end of the file.
+ *
+ * @param file The mapped file (usually with the header already read). @see next_mapped_line
+ * @param chunks The array where the chunks are saved (must have space for MAX_MAPPED_CHUNKS).
+ * @return int The number of chunks.
+ */
+int split_mapped_chunks(MAPPED_FILE *file, MAPPED_CHUNK *chunks) {
+    char *end = file->data + file->size;
+    size_t remaining = end > file->cursor ? (size_t) (end - file->cursor) : 0;
+    int count = (int) g_get_num_processors();
+    if (count > MAX_MAPPED_CHUNKS) {
+        count = MAX_MAPPED_CHUNKS;
+    }
+    if ((size_t) count > remaining / MIN_MAPPED_CHUNK_SIZE) {
+        count = (int) (remaining / MIN_MAPPED_CHUNK_SIZE);
+    }
+    if (count < 1) {
+        count = 1;
+    }
+
+    char *start = file->cursor;
+    int chunks_count = 0;
+    for (int i = 0; i < count && start < end; i++) {
+        char *chunk_end = end;
+        if (i < count - 1) {
+            // move the (approximate) end of the chunk to the end of its line
+            chunk_end = file->cursor + remaining / count * (i + 1);
+            if (chunk_end < start) {
+                chunk_end = start;
+            }
+            char *newline = memchr(chunk_end, '\n', end - chunk_end);
+            chunk_end = newline != NULL ? newline + 1 : end;
+        }
+        chunks[chunks_count].cursor = start;
+        chunks[chunks_count].end = chunk_end;
+        chunks_count++;
+        start = chunk_end;
+    }
+    if (chunks_count == 0) {
+        // nothing left to read, a single empty chunk
+        chunks[0].cursor = end;
+        chunks[0].end = end;
+        chunks_count = 1;
+    }
+    file->cursor = end;
+    return chunks_count;
+}
+
+/**
+ * @brief Gets the next record of a chunk, split in fields in place. @see next_mapped_record
+ *
+ * @param chunk The chunk. @see split_mapped_chunks
+ * @param fields The array where the fields are saved (must have space for max_fields).
+ * @param max_fields The number of fields expected (missing fields are empty, extra fields are ignored).
+ * @param fields_count Where the number of fields found is saved (use it to restore the line, @see restore_line).
+ * @return char* The line (a slice of the mapped file) or NULL if there are no more lines in the chunk.
+ */
+char *next_chunk_record(MAPPED_CHUNK *chunk, char **fields, int max_fields, int *fields_count) {
+    if (chunk->cursor >= chunk->end) {
+        return NULL;
+    }
+    char *line = chunk->cursor;
+    chunk->cursor = scan_fields(line, chunk->end, fields, max_fields, fields_count);
+    return line;
+}
+
+/**
+ * @brief Runs a worker for each chunk task, in parallel (the first task runs in the calling thread), and waits for all of them.
+ *
+ * @param worker The function that parses a chunk (receives a pointer to its task).
+ * @param tasks The array of tasks (one per chunk).
+ * @param task_size The size of each task in bytes.
+ * @param tasks_count The number of tasks. @see split_mapped_chunks
+ */
+void run_chunk_workers(void *(*worker)(void *), void *tasks, size_t task_size, int tasks_count) {
+    GThread *threads[MAX_MAPPED_CHUNKS];
+    for (int i = 1; i < tasks_count; i++) {
+        threads[i] = g_thread_new("chunk", worker, (char *) tasks + i * task_size);
+    }
+    worker(tasks);
+    for (int i = 1; i < tasks_count; i++) {
+        g_thread_join(threads[i]);
+    }
+}
+
+/**
+ * @brief Restores a line split by the field scanner (puts back the ';' between the fields), e.g. to save it in the errors file.
+ *
+ * @param fields The fields of the line. @see next_mapped_record
+ * @param max_fields The number of fields expected.
+ * @param fields_count The number of fields found in the line (max_fields + 1 if the extra fields were cut).
+ */
+void restore_line(char **fields, int max_fields, int fields_count) {
+    for (int i = 1; i < fields_count && i < max_fields; i++) {
+        fields[i][-1] = ';';
+    }
+    if (fields_count > max_fields) {
+        // the ';' that ended the last field
+        char *last = fields[max_fields - 1];
+        last[strlen(last)] = ';';
+    }
+}
+
+/**
+ * @brief Unmaps a mapped file (every slice of it stops being valid).
+ *
+ * @param file The mapped file. @see open_mapped_dataset
+ */
+void close_mapped_dataset(MAPPED_FILE *file) {
+    if (file != NULL) {
+        munmap(file->data, file->map_size);
+        g_free(file);
+    }
+}
@@ -6,6 +6,9 @@
 #include "parsers/flights.h"
 #include "validation.h"
 #include "utils.h"
+#include "statistics.h"
+#include "mappedFile.h"
+#include "arena.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -13,30 +16,7 @@
 
 #define DATASET_NAME "flights.csv"
 #define ERRORS_DATASET_NAME "flights_errors.csv"
-
-// Function to free memory allocated for a User struct
-/**
- * @brief Frees the memory allocated for a flight.
- * 
- * @param data The data to be freed.
-*/
-void free_flight(gpointer data) {
-    FLIGHT *flight = (FLIGHT *)data;
-    g_free(flight->id);
-    g_free(flight->airline);
-    g_free(flight->plane_model);
-    g_free(flight->total_seats);
-    g_free(flight->origin);
-    g_free(flight->destination);
-    g_free(flight->schedule_departure_date);
-    g_free(flight->schedule_arrival_date);
-    g_free(flight->real_departure_date);
-    g_free(flight->real_arrival_date);
-    g_free(flight->pilot);
-    g_free(flight->copilot);
-    //g_free(flight->notes);
-    g_free(flight);
-}
+#define DATASET_FIELDS 13
 
 // Function to print User struct stored in the hash table
 /**
@@ -53,13 +33,18 @@ void print_hash_flight(gpointer key, gpointer value, gpointer data) {
     printf("Flight ID: %s\n", flight->id);
     printf("\tAirline: %s\n", flight->airline);
     printf("\tPlane Model: %s\n", flight->plane_model);
-    printf("\tTotal Seats: %s\n", flight->total_seats);
+    printf("\tTotal Seats: %d\n", flight->total_seats);
     printf("\tOrigin: %s\n", flight->origin);
     printf("\tDestination: %s\n", flight->destination);
-    printf("\tSchedule Departure Date: %s\n", flight->schedule_departure_date);
-    printf("\tSchedule Arrival Date: %s\n", flight->schedule_arrival_date);
-    printf("\tReal Departure Date: %s\n", flight->real_departure_date);
-    printf("\tReal Arrival Date: %s\n", flight->real_arrival_date);
+    char date[DATE_STRING_SIZE];
+    formatDate(flight->schedule_departure_date, DATE_TIME, date);
+    printf("\tSchedule Departure Date: %s\n", date);
+    formatDate(flight->schedule_arrival_date, DATE_TIME, date);
+    printf("\tSchedule Arrival Date: %s\n", date);
+    formatDate(flight->real_departure_date, DATE_TIME, date);
+    printf("\tReal Departure Date: %s\n", date);
+    formatDate(flight->real_arrival_date, DATE_TIME, date);
+    printf("\tReal Arrival Date: %s\n", date);
     printf("\tPilot: %s\n", flight->pilot);
     printf("\tCopilot: %s\n", flight->copilot);
     //printf("\tNotes: %s\n", flight->notes);
@@ -68,101 +53,181 @@ void print_hash_flight(gpointer key, gpointer value, gpointer data) {
 // Function to parse a CSV file and populate a GHashTable with User structs
 /**
  * @brief Parses a CSV file and populates a GHashTable with flights.
+ *      The file is mapped and tokenized in place, the flights fields are slices of the mapped file.
+ *      The valid flights are allocated in the arena (so they are not freed by the hash table).
  * 
  * @param datasetDir The directory of the dataset.
  * @param outputDir The directory of the output.
+ * @param arena The arena where the flights are allocated (it must outlive the flights, @see add_catalog_arena).
+ * @param strings The string pool where the airlines, plane models and airports are interned. @see intern_string
+ * @param source Where the mapped file is returned (it must outlive the flights, @see add_catalog_source).
  * @return GHashTable* The hash table with the flights.
 */
-GHashTable* parse_flights(const char* datasetDir, const char* outputDir) {
-    GHashTable* flights = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, free_flight);
-
-    char datasetPath[MAX_PATH_LENGTH];
-    // if datasetDir ends in /, remove it
-    if (datasetDir[strlen(datasetDir) - 1] == '/') {
-        snprintf(datasetPath, MAX_PATH_LENGTH, "%s%s", datasetDir, DATASET_NAME);
-    } else {
-        snprintf(datasetPath, MAX_PATH_LENGTH, "%s/%s", datasetDir, DATASET_NAME);
-    }
-    FILE* file = fopen(datasetPath, "r");
-    if (!file) {
-        perror("Error opening file");
-        exit(EXIT_FAILURE);
-    }
+GHashTable* parse_flights(const char* datasetDir, const char* outputDir, ARENA *arena, STRING_POOL *strings, MAPPED_FILE **source) {
+    GHashTable* flights = g_hash_table_new(g_str_hash, g_str_equal);
+
+    MAPPED_FILE *file = open_mapped_dataset(datasetDir, DATASET_NAME);
 
-    char line[MAX_LINE_SIZE];
     // Read header line (assuming the first line is the header)
-    if (!fgets(line, sizeof(line), file)) {
+    char *line = next_mapped_line(file);
+    if (!line) {
         perror("Error reading header");
         exit(EXIT_FAILURE);
     }
 
     // initialize error registery
-    FILE *error_registery = initialize_error_registery(outputDir, ERRORS_DATASET_NAME);
+    ERROR_REGISTERY *error_registery = initialize_error_registery(outputDir, ERRORS_DATASET_NAME);
 
     // add header to errors file
-    line[strcspn(line, "\n")] = '\0';
     register_error_line(error_registery, line);
 
-    int line_count = 0;
-    while (fgets(line, sizeof(line), file)) {
-        line_count++;
-        // Remove newline character from the end
-        line[strcspn(line, "\n")] = '\0';
-
-        gchar** tokens = g_strsplit(line, ";", -1);
-        FLIGHT* flight = g_new0(FLIGHT, 1);
-
-        if (tokens) {
-            flight->id = g_strdup(tokens[0]);
-            flight->airline = g_strdup(tokens[1]);
-            flight->plane_model = g_strdup(tokens[2]);
-            flight->total_seats = g_strdup(tokens[3]);
-            flight->origin = g_strdup(tokens[4]);
-            flight->destination = g_strdup(tokens[5]);
-            flight->schedule_departure_date = g_strdup(tokens[6]);
-            flight->schedule_arrival_date = g_strdup(tokens[7]);
-            flight->real_departure_date = g_strdup(tokens[8]);
-            flight->real_arrival_date = g_strdup(tokens[9]);
-            flight->pilot = g_strdup(tokens[10]);
-            flight->copilot = g_strdup(tokens[11]);
-            //flight->notes = g_strdup(tokens[12]);
-            
-            /*int numberOfPassengers = 0;
-            if (flight->id != NULL) {
-                numberOfPassengers = get_flight_passengers(flight->id, datasetDir);
-            }*/
-
-            // if validations fail
-            if (validateTrip(flight->origin, flight->destination) != 1
-            || compareDates(flight->schedule_departure_date, flight->schedule_arrival_date) != 1
-            || compareDates(flight->real_departure_date, flight->real_arrival_date) != 1
-            || isInt(flight->total_seats) != 1
-            //|| validateSeats(atoi(flight->total_seats), numberOfPassengers) != 1
-            || validateFieldSize(flight->id) != 1 || validateFieldSize(flight->airline) != 1 || validateFieldSize(flight->plane_model) != 1 || validateFieldSize(flight->pilot) != 1 || validateFieldSize(flight->copilot) != 1) {
-                // add to errors file
-                register_error_line(error_registery, line);
-                free_flight(flight);
-            } else {
-                g_hash_table_insert(flights, flight->id, flight);
-            }
-            
-            g_strfreev(tokens); // Free the array of strings
+    char *tokens[DATASET_FIELDS];
+    int fields_count;
+    while ((line = next_mapped_record(file, tokens, DATASET_FIELDS, &fields_count)) != NULL) {
+        // the flight is built on the stack and only copied to the arena if it is valid
+        FLIGHT stack_flight;
+        FLIGHT *flight = &stack_flight;
+
+        flight->id = tokens[0];
+        flight->airline = tokens[1];
+        flight->plane_model = tokens[2];
+        flight->origin = tokens[4];
+        flight->destination = tokens[5];
+        flight->pilot = tokens[10];
+        flight->copilot = tokens[11];
+        //flight->notes = tokens[12];
+
+        // if validations fail (the dates are converted while they are validated)
+        if (validateTrip(flight->origin, flight->destination) != 1
+        || parseDateRange(tokens[6], tokens[7], &flight->schedule_departure_date, &flight->schedule_arrival_date) != 1
+        || parseDateRange(tokens[8], tokens[9], &flight->real_departure_date, &flight->real_arrival_date) != 1
+        || isInt(tokens[3]) != 1
+        //|| validateSeats(atoi(flight->total_seats), numberOfPassengers) != 1
+        || validateFieldSize(flight->id) != 1 || validateFieldSize(flight->airline) != 1 || validateFieldSize(flight->plane_model) != 1 || validateFieldSize(flight->pilot) != 1 || validateFieldSize(flight->copilot) != 1) {
+            // add to errors file (with the ';' back in place)
+            restore_line(tokens, DATASET_FIELDS, fields_count);
+            register_error_line(error_registery, line);
         } else {
-            // Handle the case where g_strsplit fails
-            fprintf(stderr, "Error splitting line: %s\n", line);
-            g_free(flight); // Free the partially allocated USER struct
-            continue;
+            flight->total_seats = atoi(tokens[3]);
+            flight->airline = intern_string(strings, flight->airline);
+            flight->plane_model = intern_string(strings, flight->plane_model);
+            flight->origin = intern_string(strings, flight->origin);
+            flight->destination = intern_string(strings, flight->destination);
+            flight = arena_copy(arena, flight, sizeof(FLIGHT));
+            g_hash_table_insert(flights, flight->id, flight);
         }
     }
 
     // close error registery
     close_error_registery(error_registery);
 
-    fclose(file);
+    *source = file;
 
     return flights;
 }
 
+/**
+ * @brief Replaces the interned strings of the flights after their string pool is merged into another one. @see merge_string_pools
+ * 
+ * @param flights The hash table of flights.
+ * @param remap The remap table of the merge (can be NULL).
+*/
+void remap_flights_strings(GHashTable *flights, GHashTable *remap) {
+    if (remap == NULL) {
+        return;
+    }
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, flights);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT *flight = (FLIGHT *) value;
+        flight->airline = remap_interned_string(remap, flight->airline);
+        flight->plane_model = remap_interned_string(remap, flight->plane_model);
+        flight->origin = remap_interned_string(remap, flight->origin);
+        flight->destination = remap_interned_string(remap, flight->destination);
+    }
+}
+
+/**
+ * @brief Compares two flights by schedule_departure_date (most recent first) and, when they depart at the same time, by id (ascending).
+ * 
+ * @param a A pointer to the first flight (FLIGHT**).
+ * @param b A pointer to the second flight (FLIGHT**).
+ * @return int The comparator (< 0 if a comes first).
+*/
+static int compare_origin_flights(const void *a, const void *b) {
+    FLIGHT *flight_a = *(FLIGHT **) a;
+    FLIGHT *flight_b = *(FLIGHT **) b;
+    if (flight_a->schedule_departure_date != flight_b->schedule_departure_date) {
+        return flight_a->schedule_departure_date < flight_b->schedule_departure_date ? 1 : -1;
+    }
+    return strcmp(flight_a->id, flight_b->id);
+}
+
+/**
+ * @brief Builds the index of the flights by origin airport (in upper case, so the airports are found ignoring the case),
+ *      each airport with its flights sorted by schedule_departure_date (most recent first) and id and the median of their delays.
+ * 
+ * @param flights The hash table of flights.
+ * @param arena The arena where the index entries, airport names and arrays are allocated.
+ * @return GHashTable* The index (upper case origin -> AIRPORT_FLIGHTS).
+*/
+GHashTable *index_origin_flights(GHashTable *flights, ARENA *arena) {
+    GHashTable *index = g_hash_table_new(g_str_hash, g_str_equal);
+    // the origins are interned, so each one is only put in upper case once (origin -> AIRPORT_FLIGHTS)
+    GHashTable *origins = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GHashTableIter iter;
+    gpointer key, value;
+    // count the flights of each airport
+    g_hash_table_iter_init(&iter, flights);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT *flight = (FLIGHT *) value;
+        AIRPORT_FLIGHTS *entry = g_hash_table_lookup(origins, flight->origin);
+        if (entry == NULL) {
+            char *airport = toupper_str(flight->origin);
+            entry = g_hash_table_lookup(index, airport);
+            if (entry == NULL) {
+                entry = arena_alloc(arena, sizeof(AIRPORT_FLIGHTS));
+                entry->airport = arena_copy(arena, airport, strlen(airport) + 1);
+                entry->flights = NULL;
+                entry->total_flights = 0;
+                g_hash_table_insert(index, entry->airport, entry);
+            }
+            g_free(airport);
+            g_hash_table_insert(origins, flight->origin, entry);
+        }
+        entry->total_flights++;
+    }
+    // allocate the arrays with their final size
+    g_hash_table_iter_init(&iter, index);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        AIRPORT_FLIGHTS *entry = (AIRPORT_FLIGHTS *) value;
+        entry->flights = arena_alloc(arena, entry->total_flights * sizeof(FLIGHT*));
+        entry->total_flights = 0;
+    }
+    // fill the arrays
+    g_hash_table_iter_init(&iter, flights);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT *flight = (FLIGHT *) value;
+        AIRPORT_FLIGHTS *entry = g_hash_table_lookup(origins, flight->origin);
+        entry->flights[entry->total_flights++] = flight;
+    }
+    g_hash_table_destroy(origins);
+    // and sort them once (the order of query 5) and find the median of their delays (query 7)
+    int *delays = g_malloc(MAX(g_hash_table_size(flights), 1) * sizeof(int));
+    g_hash_table_iter_init(&iter, index);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        AIRPORT_FLIGHTS *entry = (AIRPORT_FLIGHTS *) value;
+        qsort(entry->flights, entry->total_flights, sizeof(FLIGHT*), compare_origin_flights);
+        for (int i = 0; i < entry->total_flights; i++) {
+            delays[i] = get_flight_delay(entry->flights[i]);
+        }
+        entry->median_delay = median_delay(delays, entry->total_flights);
+    }
+    g_free(delays);
+    return index;
+}
+
 // Function to free the memory used by the hash table and its contents
 /**
  * @brief Frees the memory used by the hash table and its contents.
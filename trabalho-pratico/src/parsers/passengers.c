@@ -8,6 +8,8 @@
 #include "parsers/flights.h"
 #include "validation.h"
 #include "utils.h"
+#include "mappedFile.h"
+#include "arena.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -15,6 +17,7 @@
 
 #define DATASET_NAME "passengers.csv"
 #define ERRORS_DATASET_NAME "passengers_errors.csv"
+#define DATASET_FIELDS 2
 
 /*
 typedef struct flight_seats {
@@ -24,22 +27,6 @@ typedef struct flight_seats {
 } FLIGHT_SEATS;*/
 // remember this time its a little different, we need to add the user id to the passengers array if the flight_id already exists in the hash table
 
-// Function to free memory allocated for a User struct
-/**
- * @brief Frees the memory allocated for a flight.
- * 
- * @param data The data to be freed.
-*/
-void free_flight_seats(gpointer data) {
-    FLIGHT_SEATS *flight_seats = (FLIGHT_SEATS *)data;
-    g_free(flight_seats->flight_id);
-    for (int i = 0; i < flight_seats->total_passengers; i++) {
-        g_free(flight_seats->passengers[i]);
-    }
-    g_free(flight_seats->passengers);
-    g_free(flight_seats);
-}
-
 // Function to print User struct stored in the hash table
 /**
  * @brief Prints a flight.
@@ -59,97 +46,322 @@ void print_hash_passenger(gpointer key, gpointer value, gpointer data) {
     printf("\tTotal Passengers: %d\n", flight_seats->total_passengers);
 }
 
+typedef struct passengers_chunk {
+    MAPPED_CHUNK chunk;
+    GHashTable *users; // read only
+    GHashTable *flights; // read only
+    GHashTable *passengers; // passengers of each flight in the chunk (flight_id -> GPtrArray of user ids)
+    GPtrArray *order; // flight ids, in the order they first appear in the chunk
+    GPtrArray *errors; // rejected lines, in file order
+} PASSENGERS_CHUNK;
+
+/**
+ * @brief Parses and validates the lines of a chunk of the passengers file (runs in a parser worker).
+ *      The passengers of each flight are partial (only the ones in the chunk), they are merged in the file order. @see parse_passengers
+ * 
+ * @param data The chunk. @see struct PASSENGERS_CHUNK
+ * @return gpointer NULL.
+*/
+static gpointer parse_passengers_chunk(gpointer data) {
+    PASSENGERS_CHUNK *task = (PASSENGERS_CHUNK *) data;
+    char *tokens[DATASET_FIELDS];
+    char *line;
+    int fields_count;
+    while ((line = next_chunk_record(&task->chunk, tokens, DATASET_FIELDS, &fields_count)) != NULL) {
+        char *flight_id = tokens[0];
+        char *user_id = tokens[1];
+
+        // if validations fail
+        if (validateFieldSize(flight_id) != 1 || isValidUser(task->users, user_id) != 1 || isFlightValid(task->flights, flight_id) != 1) {
+            // add to errors (with the ';' back in place)
+            restore_line(tokens, DATASET_FIELDS, fields_count);
+            g_ptr_array_add(task->errors, line);
+            continue;
+        }
+
+        // if flight_id already exists in the hash table add it to the passengers array
+        // else add it to the hash table
+        GPtrArray *flight_passengers = g_hash_table_lookup(task->passengers, flight_id);
+        if (flight_passengers == NULL) {
+            flight_passengers = g_ptr_array_new();
+            g_hash_table_insert(task->passengers, flight_id, flight_passengers);
+            g_ptr_array_add(task->order, flight_id);
+        }
+        g_ptr_array_add(flight_passengers, user_id);
+    }
+    return NULL;
+}
+
 // Function to parse a CSV file and populate a GHashTable with User structs
 /**
  * @brief Parses a CSV file and populates a GHashTable with flight seats.
+ *      The file is mapped and tokenized in place, the flight and user ids are slices of the mapped file.
+ *      The file is split in chunks (at newline boundaries) parsed in parallel, the partial passengers of each chunk
+ *      are merged in the file order, so the passengers arrays, the hash table and the errors file are the same as when parsing line by line.
+ *      The flight seats and their passengers arrays (with the exact size) are allocated in the arena.
  * 
  * @param datasetDir The path to the dataset directory.
  * @param outputDir The path to the output directory.
  * @param users The hash table of users. @see parse_users
  * @param flights The hash table of flights. @see parse_flights
+ * @param arena The arena where the flight seats are allocated (it must outlive the passengers, @see add_catalog_arena).
+ * @param user_flights Where the flights of each user are returned (allocated in the arena). @see index_user_flights
+ * @param source Where the mapped file is returned (it must outlive the passengers, @see add_catalog_source).
  * @return The hash table of flight seats (passengers).
 */
-GHashTable* parse_passengers(const char* datasetDir, const char* outputDir, GHashTable* users, GHashTable* flights) {
-    GHashTable* passengers = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, free_flight_seats);
-
-    char datasetPath[MAX_PATH_LENGTH];
-    // if datasetDir ends in /, remove it
-    if (datasetDir[strlen(datasetDir) - 1] == '/') {
-        snprintf(datasetPath, MAX_PATH_LENGTH, "%s%s", datasetDir, DATASET_NAME);
-    } else {
-        snprintf(datasetPath, MAX_PATH_LENGTH, "%s/%s", datasetDir, DATASET_NAME);
-    }
-    FILE* file = fopen(datasetPath, "r");
-    if (!file) {
-        perror("Error opening file");
-        exit(EXIT_FAILURE);
-    }
+GHashTable* parse_passengers(const char* datasetDir, const char* outputDir, GHashTable* users, GHashTable* flights, ARENA *arena, USER_FLIGHTS **user_flights, MAPPED_FILE **source) {
+    GHashTable* passengers = g_hash_table_new(g_str_hash, g_str_equal);
+
+    MAPPED_FILE *file = open_mapped_dataset(datasetDir, DATASET_NAME);
 
-    char line[MAX_LINE_SIZE];
     // Read header line (assuming the first line is the header)
-    if (!fgets(line, sizeof(line), file)) {
+    char *line = next_mapped_line(file);
+    if (!line) {
         perror("Error reading header");
         exit(EXIT_FAILURE);
     }
 
     // initialize error registery
-    FILE *error_registery = initialize_error_registery(outputDir, ERRORS_DATASET_NAME);
+    ERROR_REGISTERY *error_registery = initialize_error_registery(outputDir, ERRORS_DATASET_NAME);
 
     // add header to errors file
-    line[strcspn(line, "\n")] = '\0';
     register_error_line(error_registery, line);
 
-    int line_count = 0;
-    while (fgets(line, sizeof(line), file)) {
-        line_count++;
-        // Remove newline character from the end
-        line[strcspn(line, "\n")] = '\0';
-
-        gchar** tokens = g_strsplit(line, ";", -1);
-        FLIGHT_SEATS *flight_seats = g_new(FLIGHT_SEATS, 1);
-
-        if (tokens) {
-            flight_seats->flight_id = g_strdup(tokens[0]);
-            flight_seats->passengers = g_new(char*, 1);
-            flight_seats->passengers[0] = g_strdup(tokens[1]);
-            flight_seats->total_passengers = 1;
-
-            // if validations fail
-            if (validateFieldSize(flight_seats->flight_id) != 1 || isValidUser(users, flight_seats->passengers[0]) != 1 || isFlightValid(flights, flight_seats->flight_id) != 1) {
-                // add to errors file
-                register_error_line(error_registery, line);
-                free_flight_seats(flight_seats);
-            } else {
-                // if flight_id already exists in the hash table add it to the passengers array
-                // else add it to the hash table
-                FLIGHT_SEATS *flight_seats_in_hash_table = g_hash_table_lookup(passengers, flight_seats->flight_id);
-                if (flight_seats_in_hash_table != NULL) {
-                    flight_seats_in_hash_table->total_passengers++;
-                    flight_seats_in_hash_table->passengers = g_realloc(flight_seats_in_hash_table->passengers, flight_seats_in_hash_table->total_passengers * sizeof(char*));
-                    flight_seats_in_hash_table->passengers[flight_seats_in_hash_table->total_passengers - 1] = g_strdup(tokens[1]);
-                    free_flight_seats(flight_seats);
-                } else {
-                    g_hash_table_insert(passengers, flight_seats->flight_id, flight_seats);
-                }
+    MAPPED_CHUNK chunks[MAX_MAPPED_CHUNKS];
+    int chunks_count = split_mapped_chunks(file, chunks);
+    PASSENGERS_CHUNK tasks[MAX_MAPPED_CHUNKS];
+    for (int i = 0; i < chunks_count; i++) {
+        tasks[i].chunk = chunks[i];
+        tasks[i].users = users;
+        tasks[i].flights = flights;
+        tasks[i].passengers = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_ptr_array_unref);
+        tasks[i].order = g_ptr_array_new();
+        tasks[i].errors = g_ptr_array_new();
+    }
+    run_chunk_workers(parse_passengers_chunk, tasks, sizeof(PASSENGERS_CHUNK), chunks_count);
+
+    // first count the passengers of each flight in all the chunks (the flights are added in the file order)
+    for (int i = 0; i < chunks_count; i++) {
+        for (guint j = 0; j < tasks[i].order->len; j++) {
+            char *flight_id = g_ptr_array_index(tasks[i].order, j);
+            GPtrArray *flight_passengers = g_hash_table_lookup(tasks[i].passengers, flight_id);
+            FLIGHT_SEATS *flight_seats = g_hash_table_lookup(passengers, flight_id);
+            if (flight_seats == NULL) {
+                flight_seats = arena_alloc(arena, sizeof(FLIGHT_SEATS));
+                flight_seats->flight_id = flight_id;
+                flight_seats->total_passengers = 0;
+                g_hash_table_insert(passengers, flight_seats->flight_id, flight_seats);
             }
-            
-            g_strfreev(tokens); // Free the array of strings
-        } else {
-            // Handle the case where g_strsplit fails
-            fprintf(stderr, "Error splitting line: %s\n", line);
-            g_free(passengers); // Free the partially allocated USER struct
-            continue;
+            flight_seats->total_passengers += flight_passengers->len;
+        }
+        for (guint j = 0; j < tasks[i].errors->len; j++) {
+            register_error_line(error_registery, g_ptr_array_index(tasks[i].errors, j));
         }
     }
 
+    // then allocate each passengers array once, with its final size
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, passengers);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT_SEATS *flight_seats = (FLIGHT_SEATS *) value;
+        flight_seats->passengers = arena_alloc(arena, flight_seats->total_passengers * sizeof(char*));
+        flight_seats->total_passengers = 0;
+    }
+
+    // and copy the passengers of the chunks in the file order (the passengers of a flight are appended to the ones of the previous chunks)
+    for (int i = 0; i < chunks_count; i++) {
+        for (guint j = 0; j < tasks[i].order->len; j++) {
+            char *flight_id = g_ptr_array_index(tasks[i].order, j);
+            GPtrArray *flight_passengers = g_hash_table_lookup(tasks[i].passengers, flight_id);
+            FLIGHT_SEATS *flight_seats = g_hash_table_lookup(passengers, flight_id);
+            memcpy(flight_seats->passengers + flight_seats->total_passengers, flight_passengers->pdata, flight_passengers->len * sizeof(char*));
+            flight_seats->total_passengers += flight_passengers->len;
+        }
+        g_hash_table_destroy(tasks[i].passengers);
+        g_ptr_array_free(tasks[i].order, TRUE);
+        g_ptr_array_free(tasks[i].errors, TRUE);
+    }
+
     // close error registery
     close_error_registery(error_registery);
 
-    fclose(file);
+    // the flights of each user (the passengers inverted)
+    *user_flights = index_user_flights(passengers, flights, arena);
+
+    *source = file;
 
     return passengers;
 }
 
+/**
+ * @brief Compares two airports by name (for g_ptr_array_sort).
+ * 
+ * @param a A pointer to the first airport (char**).
+ * @param b A pointer to the second airport (char**).
+ * @return gint The comparator (< 0 if a comes first).
+*/
+static gint compare_airport_names(gconstpointer a, gconstpointer b) {
+    return strcmp(*(char **) a, *(char **) b);
+}
+
+/**
+ * @brief Gets the column of an airport in the passengers table (the airports are interned, so each one is only put in upper case once).
+ * 
+ * @param columns The columns of all the airports (upper case airport -> column + 1).
+ * @param airports The columns of the interned airports already found (interned airport -> column + 1).
+ * @param airport The interned airport.
+ * @return int The column of the airport.
+*/
+static int airport_column(GHashTable *columns, GHashTable *airports, char *airport) {
+    gpointer column = g_hash_table_lookup(airports, airport);
+    if (column == NULL) {
+        char *airport_upper = toupper_str(airport);
+        column = g_hash_table_lookup(columns, airport_upper);
+        g_free(airport_upper);
+        g_hash_table_insert(airports, airport, column);
+    }
+    return GPOINTER_TO_INT(column) - 1;
+}
+
+/**
+ * @brief Builds the passengers of each airport in each year (@see struct AIRPORT_PASSENGERS): the passengers of a flight
+ *      are added to its origin and its destination, in the year of its schedule_departure_date.
+ * 
+ * @param flights The hash table of flights.
+ * @param passengers The hash table of passengers. @see parse_passengers
+ * @param arena The arena where the table, the airports and the rows are allocated.
+ * @return AIRPORT_PASSENGERS* The table (only its years hash table must be destroyed).
+*/
+AIRPORT_PASSENGERS *index_airport_passengers(GHashTable *flights, GHashTable *passengers, ARENA *arena) {
+    AIRPORT_PASSENGERS *table = arena_alloc(arena, sizeof(AIRPORT_PASSENGERS));
+    table->years = g_hash_table_new(g_direct_hash, g_direct_equal);
+    // first the airports (in upper case, without repetitions), sorted by name
+    GHashTable *names = g_hash_table_new(g_str_hash, g_str_equal);
+    GPtrArray *airports = g_ptr_array_new_with_free_func(g_free);
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, flights);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT *flight = (FLIGHT *) value;
+        char *flight_airports[2] = { flight->origin, flight->destination };
+        for (int i = 0; i < 2; i++) {
+            char *airport = toupper_str(flight_airports[i]);
+            if (g_hash_table_contains(names, airport)) {
+                g_free(airport);
+            } else {
+                g_hash_table_add(names, airport);
+                g_ptr_array_add(airports, airport);
+            }
+        }
+    }
+    g_hash_table_destroy(names);
+    g_ptr_array_sort(airports, compare_airport_names);
+    table->airports_count = airports->len;
+    table->airports = arena_alloc(arena, MAX(airports->len, 1) * sizeof(char*));
+    GHashTable *columns = g_hash_table_new(g_str_hash, g_str_equal);
+    for (guint i = 0; i < airports->len; i++) {
+        char *airport = g_ptr_array_index(airports, i);
+        table->airports[i] = arena_copy(arena, airport, strlen(airport) + 1);
+        g_hash_table_insert(columns, table->airports[i], GINT_TO_POINTER(i + 1));
+    }
+    g_ptr_array_free(airports, TRUE);
+
+    // then the passengers of each flight, in the row of its year
+    GHashTable *interned_columns = g_hash_table_new(g_direct_hash, g_direct_equal);
+    g_hash_table_iter_init(&iter, flights);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT *flight = (FLIGHT *) value;
+        int year = DATETIME_YEAR(flight->schedule_departure_date);
+        int *row = g_hash_table_lookup(table->years, GINT_TO_POINTER(year));
+        if (row == NULL) {
+            row = arena_alloc(arena, MAX(table->airports_count, 1) * sizeof(int));
+            for (int i = 0; i < table->airports_count; i++) {
+                row[i] = -1;
+            }
+            g_hash_table_insert(table->years, GINT_TO_POINTER(year), row);
+        }
+        int number_of_passengers = get_flight_passengers(passengers, flight->id);
+        int columns_of_flight[2] = { airport_column(columns, interned_columns, flight->origin), airport_column(columns, interned_columns, flight->destination) };
+        for (int i = 0; i < 2; i++) {
+            if (row[columns_of_flight[i]] < 0) {
+                row[columns_of_flight[i]] = 0;
+            }
+            row[columns_of_flight[i]] += number_of_passengers;
+        }
+    }
+    g_hash_table_destroy(interned_columns);
+    g_hash_table_destroy(columns);
+    return table;
+}
+
+/**
+ * @brief Builds the flights of each user (the passengers table inverted) in compressed sparse rows. @see struct USER_FLIGHTS
+ *      The users get a row in the order they are found, then the rows are counted, the offsets computed
+ *      and the flights written in place (the offsets and the flights are two arrays allocated once, in the arena).
+ * 
+ * @param passengers The hash table of passengers. @see parse_passengers
+ * @param flights The hash table of flights (the flights of the passengers).
+ * @param arena The arena where the index arrays are allocated.
+ * @return USER_FLIGHTS* The index (allocated in the arena, only its rows hash table must be destroyed).
+*/
+USER_FLIGHTS *index_user_flights(GHashTable *passengers, GHashTable *flights, ARENA *arena) {
+    USER_FLIGHTS *index = arena_alloc(arena, sizeof(USER_FLIGHTS));
+    index->rows = g_hash_table_new(g_str_hash, g_str_equal);
+    index->users_count = 0;
+    index->flights_count = 0;
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, passengers);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        index->flights_count += ((FLIGHT_SEATS *) value)->total_passengers;
+    }
+
+    // first give each user a row (the row of each seat is kept, so the users are only looked up once) and count its flights
+    guint *seat_rows = g_malloc(MAX(index->flights_count, 1) * sizeof(guint));
+    GArray *counts = g_array_new(FALSE, TRUE, sizeof(guint));
+    guint seat = 0;
+    g_hash_table_iter_init(&iter, passengers);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT_SEATS *flight_seats = (FLIGHT_SEATS *) value;
+        for (int i = 0; i < flight_seats->total_passengers; i++) {
+            guint row = GPOINTER_TO_UINT(g_hash_table_lookup(index->rows, flight_seats->passengers[i]));
+            if (row == 0) {
+                row = ++index->users_count;
+                g_hash_table_insert(index->rows, flight_seats->passengers[i], GUINT_TO_POINTER(row));
+                g_array_set_size(counts, row);
+            }
+            g_array_index(counts, guint, row - 1)++;
+            seat_rows[seat++] = row - 1;
+        }
+    }
+
+    // then the offsets (the first flight of each row) and the flights, in the same order
+    index->offsets = arena_alloc(arena, (index->users_count + 1) * sizeof(guint));
+    index->flights = arena_alloc(arena, MAX(index->flights_count, 1) * sizeof(FLIGHT*));
+    guint offset = 0;
+    for (guint row = 0; row < index->users_count; row++) {
+        index->offsets[row] = offset;
+        offset += g_array_index(counts, guint, row);
+        // the count becomes the position where the next flight of the row is written
+        g_array_index(counts, guint, row) = index->offsets[row];
+    }
+    index->offsets[index->users_count] = offset;
+    seat = 0;
+    g_hash_table_iter_init(&iter, passengers);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT_SEATS *flight_seats = (FLIGHT_SEATS *) value;
+        FLIGHT *flight = g_hash_table_lookup(flights, flight_seats->flight_id);
+        for (int i = 0; i < flight_seats->total_passengers; i++) {
+            guint row = seat_rows[seat++];
+            index->flights[g_array_index(counts, guint, row)++] = flight;
+        }
+    }
+    g_array_free(counts, TRUE);
+    g_free(seat_rows);
+    return index;
+}
+
 // Function to free the memory used by the hash table and its contents
 /**
  * @brief Frees the memory used by the hash table and its contents.
@@ -174,4 +386,4 @@ int get_flight_passengers(GHashTable *passengers, char* flight_id) {
         return 0;
     }
     return flight_seats->total_passengers;
-}
\ No newline at end of file
+}
@@ -6,7 +6,10 @@
 #include "parsers/reservations.h"
 #include "parsers/users.h"
 #include "validation.h"
+#include "statistics.h"
 #include "utils.h"
+#include "mappedFile.h"
+#include "arena.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -14,31 +17,7 @@
 
 #define DATASET_NAME "reservations.csv"
 #define ERRORS_DATASET_NAME "reservations_errors.csv"
-
-// Function to free memory allocated
-/**
- * @brief Frees the memory allocated for a reservation.
- * 
- * @param data The data to be freed.
-*/
-void free_reservation(gpointer data) {
-    RESERVATION *reservation = (RESERVATION *)data;
-    g_free(reservation->id);
-    g_free(reservation->user_id);
-    g_free(reservation->hotel_id);
-    g_free(reservation->hotel_name);
-    g_free(reservation->hotel_stars);
-    g_free(reservation->city_tax);
-    g_free(reservation->address);
-    g_free(reservation->begin_date);
-    g_free(reservation->end_date);
-    g_free(reservation->price_per_night);
-    g_free(reservation->includes_breakfast);
-    //g_free(reservation->room_details);
-    g_free(reservation->rating);
-    //g_free(reservation->comment);
-    g_free(reservation);
-}
+#define DATASET_FIELDS 14
 
 // Function to print User struct stored in the hash table
 /**
@@ -56,115 +35,439 @@ void print_hash_reservation(gpointer key, gpointer value, gpointer data) {
     printf("\tUser ID: %s\n", reservation->user_id);
     printf("\tHotel ID: %s\n", reservation->hotel_id);
     printf("\tHotel Name: %s\n", reservation->hotel_name);
-    printf("\tHotel Stars: %s\n", reservation->hotel_stars);
-    printf("\tCity Tax: %s\n", reservation->city_tax);
+    printf("\tHotel Stars: %d\n", reservation->hotel_stars);
+    printf("\tCity Tax: %d\n", reservation->city_tax);
     printf("\tAddress: %s\n", reservation->address);
-    printf("\tBegin Date: %s\n", reservation->begin_date);
-    printf("\tEnd Date: %s\n", reservation->end_date);
-    printf("\tPrice Per Night: %s\n", reservation->price_per_night);
-    printf("\tIncludes Breakfast: %s\n", reservation->includes_breakfast);
+    char date[DATE_STRING_SIZE];
+    formatDate(reservation->begin_date, DATE_ONLY, date);
+    printf("\tBegin Date: %s\n", date);
+    formatDate(reservation->end_date, DATE_ONLY, date);
+    printf("\tEnd Date: %s\n", date);
+    printf("\tPrice Per Night: %d\n", reservation->price_per_night);
+    printf("\tIncludes Breakfast: %s\n", reservation->includes_breakfast == BREAKFAST_INCLUDED ? "True" : "False");
     //printf("\tRoom Details: %s\n", reservation->room_details);
-    printf("\tRating: %s\n", reservation->rating);
+    printf("\tRating: %d\n", reservation->rating);
     //printf("\tComment: %s\n", reservation->comment);
 }
 
+/**
+ * @brief Replaces the interned strings of a reservation after its string pool is merged into another one. @see merge_string_pools
+ * 
+ * @param reservation The reservation.
+ * @param remap The remap table of the merge (can be NULL).
+*/
+static void remap_reservation_strings(RESERVATION *reservation, GHashTable *remap) {
+    if (remap != NULL) {
+        reservation->hotel_id = remap_interned_string(remap, reservation->hotel_id);
+        reservation->hotel_name = remap_interned_string(remap, reservation->hotel_name);
+        reservation->address = remap_interned_string(remap, reservation->address);
+    }
+}
+
+typedef struct reservations_chunk {
+    MAPPED_CHUNK chunk;
+    GHashTable *users; // read only
+    ARENA *arena; // arena of the chunk, where its valid reservations are allocated
+    STRING_POOL *strings; // string pool of the chunk, where the hotels are interned
+    GPtrArray *reservations; // valid reservations, in file order
+    GPtrArray *errors; // rejected lines, in file order
+} RESERVATIONS_CHUNK;
+
+typedef struct revenue_change {
+    int day; // @see calculate_day_number
+    long long rate; // change of the revenue per night in the day
+} REVENUE_CHANGE;
+
+/**
+ * @brief Parses and validates the lines of a chunk of the reservations file (runs in a parser worker).
+ *      The results are kept in the chunk, so they can be merged in the file order. @see parse_reservations
+ * 
+ * @param data The chunk. @see struct RESERVATIONS_CHUNK
+ * @return gpointer NULL.
+*/
+static gpointer parse_reservations_chunk(gpointer data) {
+    RESERVATIONS_CHUNK *task = (RESERVATIONS_CHUNK *) data;
+    char *tokens[DATASET_FIELDS];
+    char *line;
+    int fields_count;
+    while ((line = next_chunk_record(&task->chunk, tokens, DATASET_FIELDS, &fields_count)) != NULL) {
+        // the reservation is built on the stack and only copied to the arena of the chunk if it is valid
+        RESERVATION stack_reservation;
+        RESERVATION *reservation = &stack_reservation;
+
+        reservation->id = tokens[0];
+        reservation->user_id = tokens[1];
+        reservation->hotel_id = tokens[2];
+        reservation->hotel_name = tokens[3];
+        reservation->address = tokens[6];
+        //reservation->room_details = tokens[11];
+        //reservation->comment = tokens[13];
+
+        // if validations fail (the dates and the breakfast are converted while they are validated)
+        if (isValidUser(task->users, reservation->user_id) != 1
+        || parseDateRange(tokens[7], tokens[8], &reservation->begin_date, &reservation->end_date) != 1
+        || validateRating(tokens[12]) != 1
+        || validatePrice(tokens[9]) != 1
+        || parseBreakfast(tokens[10], &reservation->includes_breakfast) != 1
+        || validateTax(tokens[5]) != 1
+        || validateStars(tokens[4]) != 1
+        || validateFieldSize(reservation->id) != 1 || validateFieldSize(reservation->user_id) != 1 || validateFieldSize(reservation->hotel_id) != 1 || validateFieldSize(reservation->hotel_name) != 1 || validateFieldSize(reservation->address) != 1) {
+            // add to errors (with the ';' back in place)
+            restore_line(tokens, DATASET_FIELDS, fields_count);
+            g_ptr_array_add(task->errors, line);
+        } else {
+            // the numbers were validated as integers, so they are only converted here
+            reservation->hotel_stars = (unsigned char) atoi(tokens[4]);
+            reservation->city_tax = atoi(tokens[5]);
+            reservation->price_per_night = atoi(tokens[9]);
+            reservation->rating = (unsigned char) atoi(tokens[12]);
+            reservation->hotel_id = intern_string(task->strings, reservation->hotel_id);
+            reservation->hotel_name = intern_string(task->strings, reservation->hotel_name);
+            reservation->address = intern_string(task->strings, reservation->address);
+            reservation = arena_copy(task->arena, reservation, sizeof(RESERVATION));
+            g_ptr_array_add(task->reservations, reservation);
+        }
+    }
+    return NULL;
+}
+
 // Function to parse a CSV file and populate a GHashTable with User structs
+/**
+ * @brief Counts a reservation in the index of the reservations by user (first pass, @see allocate_user_reservations).
+ * 
+ * @param user_reservations The index (user_id -> USER_RESERVATIONS).
+ * @param reservation The reservation.
+ * @param arena The arena where the index entries are allocated.
+*/
+static void count_user_reservation(GHashTable *user_reservations, RESERVATION *reservation, ARENA *arena) {
+    USER_RESERVATIONS *entry = g_hash_table_lookup(user_reservations, reservation->user_id);
+    if (entry == NULL) {
+        entry = arena_alloc(arena, sizeof(USER_RESERVATIONS));
+        entry->user_id = reservation->user_id;
+        entry->reservations = NULL;
+        entry->total_reservations = 0;
+        g_hash_table_insert(user_reservations, entry->user_id, entry);
+    }
+    entry->total_reservations++;
+}
+
+/**
+ * @brief Allocates the reservations array of each user of the index once, with its final size (second pass, @see add_user_reservation).
+ * 
+ * @param user_reservations The index, with the reservations of each user counted. @see count_user_reservation
+ * @param arena The arena where the arrays are allocated.
+*/
+static void allocate_user_reservations(GHashTable *user_reservations, ARENA *arena) {
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, user_reservations);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        USER_RESERVATIONS *entry = (USER_RESERVATIONS *) value;
+        entry->reservations = arena_alloc(arena, entry->total_reservations * sizeof(RESERVATION*));
+        entry->total_reservations = 0;
+    }
+}
+
+/**
+ * @brief Adds a reservation to the array of its user in the index (third pass, the reservations must be added in the same order they were counted).
+ * 
+ * @param user_reservations The index, with the arrays allocated. @see allocate_user_reservations
+ * @param reservation The reservation.
+*/
+static void add_user_reservation(GHashTable *user_reservations, RESERVATION *reservation) {
+    USER_RESERVATIONS *entry = g_hash_table_lookup(user_reservations, reservation->user_id);
+    entry->reservations[entry->total_reservations++] = reservation;
+}
+
 /**
  * @brief Parses a CSV file and populates a GHashTable with reservations.
+ *      The file is mapped and tokenized in place, the reservations fields are slices of the mapped file.
+ *      The file is split in chunks (at newline boundaries) parsed in parallel, the chunks results are merged
+ *      in the file order, so the hash table and the errors file are the same as when parsing line by line.
+ *      Each chunk allocates its valid reservations in its own arena and interns the hotels in its own string pool,
+ *      the chunks arenas and pools are merged into the given ones.
  * 
  * @param datasetDir The directory of the dataset.
  * @param outputDir The directory of the output.
  * @param users The hash table of users.
+ * @param arena The arena where the reservations are allocated (it must outlive the reservations, @see add_catalog_arena).
+ * @param strings The string pool where the hotel ids, names and addresses are interned. @see intern_string
+ * @param user_reservations Where the index of the reservations by user is returned (user_id -> USER_RESERVATIONS, allocated in the arena).
+ * @param source Where the mapped file is returned (it must outlive the reservations, @see add_catalog_source).
  * @return GHashTable* The hash table of reservations.
 */
-GHashTable* parse_reservations(const char* datasetDir, const char* outputDir, GHashTable* users) {
-    GHashTable* reservations = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, free_reservation);
+GHashTable* parse_reservations(const char* datasetDir, const char* outputDir, GHashTable* users, ARENA *arena, STRING_POOL *strings, GHashTable **user_reservations, MAPPED_FILE **source) {
+    GHashTable* reservations = g_hash_table_new(g_str_hash, g_str_equal);
 
-    char datasetPath[MAX_PATH_LENGTH];
-    // if datasetDir ends in /, remove it
-    if (datasetDir[strlen(datasetDir) - 1] == '/') {
-        snprintf(datasetPath, MAX_PATH_LENGTH, "%s%s", datasetDir, DATASET_NAME);
-    } else {
-        snprintf(datasetPath, MAX_PATH_LENGTH, "%s/%s", datasetDir, DATASET_NAME);
-    }
-    FILE* file = fopen(datasetPath, "r");
-    if (!file) {
-        perror("Error opening file");
-        exit(EXIT_FAILURE);
-    }
+    MAPPED_FILE *file = open_mapped_dataset(datasetDir, DATASET_NAME);
 
-    char line[MAX_LINE_SIZE];
     // Read header line (assuming the first line is the header)
-    if (!fgets(line, sizeof(line), file)) {
+    char *line = next_mapped_line(file);
+    if (!line) {
         perror("Error reading header");
         exit(EXIT_FAILURE);
     }
 
     // initialize error registery
-    FILE *error_registery = initialize_error_registery(outputDir, ERRORS_DATASET_NAME);
+    ERROR_REGISTERY *error_registery = initialize_error_registery(outputDir, ERRORS_DATASET_NAME);
 
     // add header to errors file
-    line[strcspn(line, "\n")] = '\0';
     register_error_line(error_registery, line);
 
-    int line_count = 0;
-    while (fgets(line, sizeof(line), file)) {
-        line_count++;
-        // Remove newline character from the end
-        line[strcspn(line, "\n")] = '\0';
-
-        gchar** tokens = g_strsplit(line, ";", -1);
-        RESERVATION* reservation = g_new0(RESERVATION, 1);
-
-        if (tokens) {
-            reservation->id = g_strdup(tokens[0]);
-            reservation->user_id = g_strdup(tokens[1]);
-            reservation->hotel_id = g_strdup(tokens[2]);
-            reservation->hotel_name = g_strdup(tokens[3]);
-            reservation->hotel_stars = g_strdup(tokens[4]);
-            reservation->city_tax = g_strdup(tokens[5]);
-            reservation->address = g_strdup(tokens[6]);
-            reservation->begin_date = g_strdup(tokens[7]);
-            reservation->end_date = g_strdup(tokens[8]);
-            reservation->price_per_night = g_strdup(tokens[9]);
-            reservation->includes_breakfast = g_strdup(tokens[10]);
-            //reservation->room_details = g_strdup(tokens[11]);
-            reservation->rating = g_strdup(tokens[12]);
-            //reservation->comment = g_strdup(tokens[13]);
-
-            // if validations fail
-            if (isValidUser(users, reservation->user_id) != 1
-            || compareDates(reservation->begin_date, reservation->end_date) != 1
-            || validateRating(reservation->rating) != 1
-            || validatePrice(reservation->price_per_night) != 1
-            || validateBreakfast(reservation->includes_breakfast) != 1
-            || validateTax(reservation->city_tax) != 1
-            || validateStars(reservation->hotel_stars) != 1
-            || validateFieldSize(reservation->id) != 1 || validateFieldSize(reservation->user_id) != 1 || validateFieldSize(reservation->hotel_id) != 1 || validateFieldSize(reservation->hotel_name) != 1 || validateFieldSize(reservation->address) != 1) {
-                // add to errors file
-                register_error_line(error_registery, line);
-                free_reservation(reservation);
-            } else {
-                g_hash_table_insert(reservations, reservation->id, reservation);
+    MAPPED_CHUNK chunks[MAX_MAPPED_CHUNKS];
+    int chunks_count = split_mapped_chunks(file, chunks);
+    RESERVATIONS_CHUNK tasks[MAX_MAPPED_CHUNKS];
+    for (int i = 0; i < chunks_count; i++) {
+        tasks[i].chunk = chunks[i];
+        tasks[i].users = users;
+        tasks[i].arena = new_arena();
+        tasks[i].strings = new_string_pool();
+        tasks[i].reservations = g_ptr_array_new();
+        tasks[i].errors = g_ptr_array_new();
+    }
+    run_chunk_workers(parse_reservations_chunk, tasks, sizeof(RESERVATIONS_CHUNK), chunks_count);
+
+    // merge the chunks in the file order (a reservation replaces an earlier one with the same id)
+    int has_duplicates = 0;
+    for (int i = 0; i < chunks_count; i++) {
+        GHashTable *remap = merge_string_pools(strings, tasks[i].strings);
+        for (guint j = 0; j < tasks[i].reservations->len; j++) {
+            RESERVATION *reservation = g_ptr_array_index(tasks[i].reservations, j);
+            remap_reservation_strings(reservation, remap);
+            if (!g_hash_table_insert(reservations, reservation->id, reservation)) {
+                has_duplicates = 1;
+            }
+        }
+        if (remap != NULL) {
+            g_hash_table_destroy(remap);
+        }
+        for (guint j = 0; j < tasks[i].errors->len; j++) {
+            register_error_line(error_registery, g_ptr_array_index(tasks[i].errors, j));
+        }
+        arena_merge(arena, tasks[i].arena);
+        g_ptr_array_free(tasks[i].errors, TRUE);
+    }
+
+    // count the reservations of each user and then fill the index, so the reservations of each user are in the file order
+    // (only the reservations kept in the hash table, like the index built from a snapshot, @see index_user_reservations)
+    GHashTable *index = g_hash_table_new(g_str_hash, g_str_equal);
+    for (int i = 0; i < chunks_count; i++) {
+        for (guint j = 0; j < tasks[i].reservations->len; j++) {
+            RESERVATION *reservation = g_ptr_array_index(tasks[i].reservations, j);
+            if (!has_duplicates || g_hash_table_lookup(reservations, reservation->id) == reservation) {
+                count_user_reservation(index, reservation, arena);
             }
-            
-            g_strfreev(tokens); // Free the array of strings
-        } else {
-            // Handle the case where g_strsplit fails
-            fprintf(stderr, "Error splitting line: %s\n", line);
-            g_free(reservations); // Free the partially allocated USER struct
-            continue;
         }
     }
+    allocate_user_reservations(index, arena);
+    for (int i = 0; i < chunks_count; i++) {
+        for (guint j = 0; j < tasks[i].reservations->len; j++) {
+            RESERVATION *reservation = g_ptr_array_index(tasks[i].reservations, j);
+            if (!has_duplicates || g_hash_table_lookup(reservations, reservation->id) == reservation) {
+                add_user_reservation(index, reservation);
+            }
+        }
+        g_ptr_array_free(tasks[i].reservations, TRUE);
+    }
+    *user_reservations = index;
 
     // close error registery
     close_error_registery(error_registery);
 
-    fclose(file);
+    *source = file;
 
     return reservations;
 }
 
+/**
+ * @brief Builds the index of the reservations by user from a hash table of reservations (e.g. loaded from a snapshot). @see parse_reservations
+ * 
+ * @param reservations The hash table of reservations.
+ * @param arena The arena where the index entries and arrays are allocated.
+ * @return GHashTable* The index (user_id -> USER_RESERVATIONS).
+*/
+GHashTable *index_user_reservations(GHashTable *reservations, ARENA *arena) {
+    GHashTable *index = g_hash_table_new(g_str_hash, g_str_equal);
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, reservations);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        count_user_reservation(index, (RESERVATION *) value, arena);
+    }
+    allocate_user_reservations(index, arena);
+    g_hash_table_iter_init(&iter, reservations);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        add_user_reservation(index, (RESERVATION *) value);
+    }
+    return index;
+}
+
+/**
+ * @brief Compares two reservations by begin_date (most recent first) and, when they begin in the same day, by id (ascending).
+ * 
+ * @param a A pointer to the first reservation (RESERVATION**).
+ * @param b A pointer to the second reservation (RESERVATION**).
+ * @return int The comparator (< 0 if a comes first).
+*/
+static int compare_hotel_reservations(const void *a, const void *b) {
+    RESERVATION *reservation_a = *(RESERVATION **) a;
+    RESERVATION *reservation_b = *(RESERVATION **) b;
+    DATETIME date_a = DATETIME_DATE(reservation_a->begin_date);
+    DATETIME date_b = DATETIME_DATE(reservation_b->begin_date);
+    if (date_a != date_b) {
+        return date_a < date_b ? 1 : -1;
+    }
+    return strcmp(reservation_a->id, reservation_b->id);
+}
+
+/**
+ * @brief Compares two revenue changes by day.
+ * 
+ * @param a A pointer to the first change (REVENUE_CHANGE*).
+ * @param b A pointer to the second change (REVENUE_CHANGE*).
+ * @return int The comparator (< 0 if a comes first).
+*/
+static int compare_revenue_changes(const void *a, const void *b) {
+    int day_a = ((const REVENUE_CHANGE *) a)->day;
+    int day_b = ((const REVENUE_CHANGE *) b)->day;
+    return (day_a > day_b) - (day_a < day_b);
+}
+
+/**
+ * @brief Builds the revenue prefix sums of a hotel (@see struct HOTEL_REVENUE): each reservation adds its price per night
+ *      to the revenue per night from its begin_date and removes it from its end_date (the night of the end_date is not paid).
+ * 
+ * @param entry The hotel, with its reservations.
+ * @param arena The arena where the arrays are allocated.
+*/
+static void build_hotel_revenue(HOTEL_RESERVATIONS *entry, ARENA *arena) {
+    int changes_count = 2 * entry->total_reservations;
+    REVENUE_CHANGE *changes = g_malloc(changes_count * sizeof(REVENUE_CHANGE));
+    for (int i = 0; i < entry->total_reservations; i++) {
+        RESERVATION *reservation = entry->reservations[i];
+        changes[2 * i].day = calculate_day_number(reservation->begin_date);
+        changes[2 * i].rate = reservation->price_per_night;
+        changes[2 * i + 1].day = calculate_day_number(reservation->end_date);
+        changes[2 * i + 1].rate = -reservation->price_per_night;
+    }
+    qsort(changes, changes_count, sizeof(REVENUE_CHANGE), compare_revenue_changes);
+
+    HOTEL_REVENUE *revenue = &entry->revenue;
+    revenue->days = arena_alloc(arena, changes_count * sizeof(int));
+    revenue->rates = arena_alloc(arena, changes_count * sizeof(long long));
+    revenue->revenue = arena_alloc(arena, changes_count * sizeof(long long));
+    revenue->days_count = 0;
+    long long rate = 0, total = 0;
+    for (int i = 0; i < changes_count; i++) {
+        // the changes of the same day are merged
+        if (revenue->days_count == 0 || revenue->days[revenue->days_count - 1] != changes[i].day) {
+            if (revenue->days_count > 0) {
+                total += rate * (changes[i].day - revenue->days[revenue->days_count - 1]);
+            }
+            revenue->days[revenue->days_count] = changes[i].day;
+            revenue->revenue[revenue->days_count] = total;
+            revenue->days_count++;
+        }
+        rate += changes[i].rate;
+        revenue->rates[revenue->days_count - 1] = rate;
+    }
+    g_free(changes);
+}
+
+/**
+ * @brief Gets the revenue of a hotel in the nights before a day. @see struct HOTEL_REVENUE
+ * 
+ * @param revenue The revenue of the hotel.
+ * @param day The day (@see calculate_day_number), its night is not included.
+ * @return long long The revenue.
+*/
+long long hotel_revenue_before(HOTEL_REVENUE *revenue, int day) {
+    // binary search of the last day where the revenue changes before (or in) the day
+    int low = 0, high = revenue->days_count;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (revenue->days[middle] <= day) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == 0) {
+        return 0;
+    }
+    int i = low - 1;
+    return revenue->revenue[i] + revenue->rates[i] * (day - revenue->days[i]);
+}
+
+/**
+ * @brief Builds the index of the reservations by hotel, each hotel with its reservations sorted by begin_date (most recent first) and id
+ *      and the prefix sums of its revenue. @see build_hotel_revenue
+ *      The hotel ids must be already interned in their final string pool (the index is keyed by the interned pointer, @see find_interned_string).
+ * 
+ * @param reservations The hash table of reservations.
+ * @param arena The arena where the index entries and arrays are allocated.
+ * @return GHashTable* The index (interned hotel_id -> HOTEL_RESERVATIONS).
+*/
+GHashTable *index_hotel_reservations(GHashTable *reservations, ARENA *arena) {
+    GHashTable *index = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GHashTableIter iter;
+    gpointer key, value;
+    // count the reservations of each hotel
+    g_hash_table_iter_init(&iter, reservations);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        RESERVATION *reservation = (RESERVATION *) value;
+        HOTEL_RESERVATIONS *entry = g_hash_table_lookup(index, reservation->hotel_id);
+        if (entry == NULL) {
+            entry = arena_alloc(arena, sizeof(HOTEL_RESERVATIONS));
+            entry->hotel_id = reservation->hotel_id;
+            entry->reservations = NULL;
+            entry->total_reservations = 0;
+            g_hash_table_insert(index, entry->hotel_id, entry);
+        }
+        entry->total_reservations++;
+    }
+    // allocate the arrays with their final size
+    g_hash_table_iter_init(&iter, index);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        HOTEL_RESERVATIONS *entry = (HOTEL_RESERVATIONS *) value;
+        entry->reservations = arena_alloc(arena, entry->total_reservations * sizeof(RESERVATION*));
+        entry->total_reservations = 0;
+    }
+    // fill the arrays
+    g_hash_table_iter_init(&iter, reservations);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        RESERVATION *reservation = (RESERVATION *) value;
+        HOTEL_RESERVATIONS *entry = g_hash_table_lookup(index, reservation->hotel_id);
+        entry->reservations[entry->total_reservations++] = reservation;
+    }
+    // and sort them once (the order of query 4) and sum their revenue (query 8)
+    g_hash_table_iter_init(&iter, index);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        HOTEL_RESERVATIONS *entry = (HOTEL_RESERVATIONS *) value;
+        qsort(entry->reservations, entry->total_reservations, sizeof(RESERVATION*), compare_hotel_reservations);
+        build_hotel_revenue(entry, arena);
+    }
+    return index;
+}
+
+/**
+ * @brief Replaces the interned strings of the reservations after their string pool is merged into another one. @see merge_string_pools
+ * 
+ * @param reservations The hash table of reservations.
+ * @param remap The remap table of the merge (can be NULL).
+*/
+void remap_reservations_strings(GHashTable *reservations, GHashTable *remap) {
+    if (remap == NULL) {
+        return;
+    }
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, reservations);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        remap_reservation_strings((RESERVATION *) value, remap);
+    }
+}
+
 // Function to free the memory used by the hash table and its contents
 /**
  * @brief Frees the memory used by the hash table and its contents.
@@ -6,36 +6,17 @@
 #include "parsers/users.h"
 #include "validation.h"
 #include "utils.h"
+#include "mappedFile.h"
+#include "arena.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <locale.h>
 
 #define DATASET_NAME "users.csv"
 #define ERRORS_DATASET_NAME "users_errors.csv"
-
-// Function to free memory allocated for a User struct
-/**
- * @brief Frees the memory allocated for a user.
- * 
- * @param data The data to be freed.
-*/
-void free_user(gpointer data) {
-    USER *user = (USER *)data;
-    g_free(user->id);
-    g_free(user->name);
-    g_free(user->email);
-    g_free(user->phone_number);
-    g_free(user->birth_date);
-    g_free(user->sex);
-    g_free(user->passport);
-    g_free(user->country_code);
-    g_free(user->address);
-    g_free(user->account_creation);
-    g_free(user->pay_method);
-    g_free(user->account_status);
-    g_free(user);
-}
+#define DATASET_FIELDS 12
 
 // Function to print User struct stored in the hash table
 /**
@@ -53,123 +34,209 @@ void print_hash_user(gpointer key, gpointer value, gpointer data) {
     printf("\tName: %s\n", user->name);
     printf("\tEmail: %s\n", user->email);
     printf("\tPhone number: %s\n", user->phone_number);
-    printf("\tBirth date: %s\n", user->birth_date);
-    printf("\tSex: %s\n", user->sex);
+    char date[DATE_STRING_SIZE];
+    formatDate(user->birth_date, DATE_ONLY, date);
+    printf("\tBirth date: %s\n", date);
+    printf("\tSex: %c\n", user->sex);
     printf("\tPassport: %s\n", user->passport);
     printf("\tCountry code: %s\n", user->country_code);
     printf("\tAddress: %s\n", user->address);
-    printf("\tAccount creation: %s\n", user->account_creation);
+    formatDate(user->account_creation, DATE_TIME, date);
+    printf("\tAccount creation: %s\n", date);
     printf("\tPay method: %s\n", user->pay_method);
-    printf("\tAccount status: %s\n", user->account_status);
+    printf("\tAccount status: %s\n", user->account_status == ACCOUNT_ACTIVE ? "active" : "inactive");
 }
 
 // Function to parse a CSV file and populate a GHashTable with User structs
 /**
  * @brief Parses a CSV file and populates a GHashTable with User structs.
+ *      The file is mapped and tokenized in place, the users fields are slices of the mapped file.
+ *      The valid users are allocated in the arena (so they are not freed by the hash table).
  * 
  * @param datasetDir The directory of the dataset.
  * @param outputDir The directory of the output.
+ * @param arena The arena where the users are allocated (it must outlive the users, @see add_catalog_arena).
+ * @param strings The string pool where the country codes and pay methods are interned. @see intern_string
+ * @param source Where the mapped file is returned (it must outlive the users, @see add_catalog_source).
  * @return GHashTable* The hash table with the users.
 */
-GHashTable* parse_users(const char* datasetDir, const char* outputDir) { 
-    GHashTable* users = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, free_user);
-
-    char datasetPath[MAX_PATH_LENGTH];
-    // if datasetDir ends in /, remove it
-    if (datasetDir[strlen(datasetDir) - 1] == '/') {
-        snprintf(datasetPath, MAX_PATH_LENGTH, "%s%s", datasetDir, DATASET_NAME);
-    } else {
-        snprintf(datasetPath, MAX_PATH_LENGTH, "%s/%s", datasetDir, DATASET_NAME);
-    }
-    FILE* file = fopen(datasetPath, "r");
-    if (!file) {
-        perror("Error opening file");
-        exit(EXIT_FAILURE);
-    }
+GHashTable* parse_users(const char* datasetDir, const char* outputDir, ARENA *arena, STRING_POOL *strings, MAPPED_FILE **source) { 
+    GHashTable* users = g_hash_table_new(g_str_hash, g_str_equal);
+
+    MAPPED_FILE *file = open_mapped_dataset(datasetDir, DATASET_NAME);
 
-    char line[MAX_LINE_SIZE];
     // Read header line (assuming the first line is the header)
-    if (!fgets(line, sizeof(line), file)) {
+    char *line = next_mapped_line(file);
+    if (!line) {
         perror("Error reading header");
         exit(EXIT_FAILURE);
     }
 
     // initialize error registery
-    FILE *error_registery = initialize_error_registery(outputDir, ERRORS_DATASET_NAME);
+    ERROR_REGISTERY *error_registery = initialize_error_registery(outputDir, ERRORS_DATASET_NAME);
 
     // add header to errors file
-    line[strcspn(line, "\n")] = '\0';
     register_error_line(error_registery, line);
 
-    int line_count = 0;
-    while (fgets(line, sizeof(line), file)) {
-        line_count++;
-        // Remove newline character from the end
-        line[strcspn(line, "\n")] = '\0';
-
-        gchar** tokens = g_strsplit(line, ";", -1);
-        USER* user = g_new0(USER, 1);
-
-        if (tokens) {
-            user->id = g_strdup(tokens[0]);
-            user->name = g_strdup(tokens[1]);
-            user->email = g_strdup(tokens[2]);
-            user->phone_number = g_strdup(tokens[3]);
-            user->birth_date = g_strdup(tokens[4]);
-            user->sex = g_strdup(tokens[5]);
-            user->passport = g_strdup(tokens[6]);
-            user->country_code = g_strdup(tokens[7]);
-            user->address = g_strdup(tokens[8]);
-            user->account_creation = g_strdup(tokens[9]);
-            user->pay_method = g_strdup(tokens[10]);
-            user->account_status = g_strdup(tokens[11]);
-
-            // Handle the case where user->id is empty
-            /*if (strlen(user->id) == 0 || user->id == NULL) {
-                //add to errors file later
-                //register_error_line(ERRORS_DATASET_NAME, outputDir, line);
-                //printf("Empty id on line %d; Line: %s\n", line_count, line);
-                // add line anyways but set id "PROGRAM_ERROR_(linenumber)"
-                char error_id[32];
-                snprintf(error_id, 32, "PROGRAM_ERROR_%d", line_count);
-                g_free(user->id);
-                user->id = g_strdup(error_id);
-                //register_error_line(error_registery, line);
-            }*/
-
-            // if validations fail
-            if (validateDate(user->birth_date) != 1
-            || validateDate(user->account_creation) != 1
-            || validateEmail(user->email) != 1
-            || validateCCode(user->country_code) != 1
-            || validateStatus(user->account_status) != 1
-            || compareDates(user->birth_date, user->account_creation) != 1
-            || validateFieldSize(user->id) != 1 || validateFieldSize(user->name) != 1 || validateFieldSize(user->phone_number) != 1 || validateFieldSize(user->sex) != 1 || validateFieldSize(user->passport) != 1 || validateFieldSize(user->address) != 1 || validateFieldSize(user->pay_method) != 1) {
-                //add to errors file later
-                //register_error_line(ERRORS_DATASET_NAME, outputDir, line);
-                register_error_line(error_registery, line);
-                free_user(user);
-            } else {
-                g_hash_table_insert(users, user->id, user);
-            }
-            
-            g_strfreev(tokens); // Free the array of strings
+    char *tokens[DATASET_FIELDS];
+    int fields_count;
+    while ((line = next_mapped_record(file, tokens, DATASET_FIELDS, &fields_count)) != NULL) {
+        // the user is built on the stack and only copied to the arena if it is valid
+        USER stack_user;
+        USER *user = &stack_user;
+
+        user->id = tokens[0];
+        user->name = tokens[1];
+        user->email = tokens[2];
+        user->phone_number = tokens[3];
+        user->passport = tokens[6];
+        user->country_code = tokens[7];
+        user->address = tokens[8];
+        user->pay_method = tokens[10];
+        user->sex = (SEX) tokens[5][0];
+
+        // if validations fail (the dates and the status are converted while they are validated, an invalid date makes the comparison fail)
+        if (parseDateRange(tokens[4], tokens[9], &user->birth_date, &user->account_creation) != 1
+        || validateEmail(user->email) != 1
+        || validateCCode(user->country_code) != 1
+        || parseStatus(tokens[11], &user->account_status) != 1
+        || validateFieldSize(user->id) != 1 || validateFieldSize(user->name) != 1 || validateFieldSize(user->phone_number) != 1 || validateFieldSize(tokens[5]) != 1 || validateFieldSize(user->passport) != 1 || validateFieldSize(user->address) != 1 || validateFieldSize(user->pay_method) != 1) {
+            // add to errors file (with the ';' back in place)
+            restore_line(tokens, DATASET_FIELDS, fields_count);
+            register_error_line(error_registery, line);
         } else {
-            // Handle the case where g_strsplit fails
-            fprintf(stderr, "Error splitting line: %s\n", line);
-            g_free(user); // Free the partially allocated USER struct
-            continue;
+            user->country_code = intern_string(strings, user->country_code);
+            user->pay_method = intern_string(strings, user->pay_method);
+            user = arena_copy(arena, user, sizeof(USER));
+            g_hash_table_insert(users, user->id, user);
         }
     }
 
     // close error registery
     close_error_registery(error_registery);
 
-    fclose(file);
+    *source = file;
 
     return users;
 }
 
+/**
+ * @brief Replaces the interned strings of the users after their string pool is merged into another one. @see merge_string_pools
+ * 
+ * @param users The hash table of users.
+ * @param remap The remap table of the merge (can be NULL).
+*/
+void remap_users_strings(GHashTable *users, GHashTable *remap) {
+    if (remap == NULL) {
+        return;
+    }
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, users);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        USER *user = (USER *) value;
+        user->country_code = remap_interned_string(remap, user->country_code);
+        user->pay_method = remap_interned_string(remap, user->pay_method);
+    }
+}
+
+typedef struct user_collation {
+    USER *user;
+    char *name_key; // strxfrm of the name
+    char *id_key; // strxfrm of the id
+    guint rank; // position in the collation order
+} USER_COLLATION;
+
+/**
+ * @brief Transforms a string with strxfrm (comparing two transformed strings with strcmp is the same as comparing them with strcoll).
+ * 
+ * @param str The string.
+ * @return char* The transformed string (must be freed).
+*/
+static char *collation_key(const char *str) {
+    size_t size = strxfrm(NULL, str, 0) + 1;
+    char *key = g_malloc(size);
+    strxfrm(key, str, size);
+    return key;
+}
+
+/**
+ * @brief Compares two users by the collation of their name and, when it is the same, of their id.
+ * 
+ * @param a The first user (USER_COLLATION*).
+ * @param b The second user (USER_COLLATION*).
+ * @return int The comparator (< 0 if a comes first).
+*/
+static int compare_user_collation(const void *a, const void *b) {
+    const USER_COLLATION *user_a = (const USER_COLLATION *) a;
+    const USER_COLLATION *user_b = (const USER_COLLATION *) b;
+    int comparator = strcmp(user_a->name_key, user_b->name_key);
+    if (comparator == 0) {
+        comparator = strcmp(user_a->id_key, user_b->id_key);
+    }
+    return comparator;
+}
+
+/**
+ * @brief Compares two users by their name in byte order (and by id, so the order is always the same).
+ * 
+ * @param a The first user (USER_COLLATION*).
+ * @param b The second user (USER_COLLATION*).
+ * @return int The comparator (< 0 if a comes first).
+*/
+static int compare_user_names(const void *a, const void *b) {
+    const USER *user_a = ((const USER_COLLATION *) a)->user;
+    const USER *user_b = ((const USER_COLLATION *) b)->user;
+    int comparator = strcmp(user_a->name, user_b->name);
+    if (comparator == 0) {
+        comparator = strcmp(user_a->id, user_b->id);
+    }
+    return comparator;
+}
+
+/**
+ * @brief Builds the index of the active users by name (@see struct USER_NAMES): the users are ranked once in the collation
+ *      of en_US.UTF-8 (with precomputed strxfrm keys instead of strcoll in every comparison) and then sorted by name in byte order,
+ *      so the users with a prefix are found with binary searches and sorted by their ranks.
+ *      It sets the LC_COLLATE of the program, so it must not run while other threads use the locale.
+ * 
+ * @param users The hash table of users.
+ * @param arena The arena where the index and its arrays are allocated.
+ * @return USER_NAMES* The index.
+*/
+USER_NAMES *index_user_names(GHashTable *users, ARENA *arena) {
+    setlocale(LC_COLLATE, "en_US.UTF-8");
+    GArray *collation = g_array_new(FALSE, FALSE, sizeof(USER_COLLATION));
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, users);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        USER *user = (USER *) value;
+        if (user->account_status != ACCOUNT_ACTIVE) continue;
+        USER_COLLATION entry = { user, collation_key(user->name), collation_key(user->id), 0 };
+        g_array_append_val(collation, entry);
+    }
+    qsort(collation->data, collation->len, sizeof(USER_COLLATION), compare_user_collation);
+    for (guint i = 0; i < collation->len; i++) {
+        USER_COLLATION *entry = &g_array_index(collation, USER_COLLATION, i);
+        entry->rank = i;
+        g_free(entry->name_key);
+        g_free(entry->id_key);
+    }
+    qsort(collation->data, collation->len, sizeof(USER_COLLATION), compare_user_names);
+
+    USER_NAMES *index = arena_alloc(arena, sizeof(USER_NAMES));
+    index->total_users = collation->len;
+    index->users = arena_alloc(arena, MAX(collation->len, 1) * sizeof(USER*));
+    index->ranks = arena_alloc(arena, MAX(collation->len, 1) * sizeof(guint));
+    for (guint i = 0; i < collation->len; i++) {
+        index->users[i] = g_array_index(collation, USER_COLLATION, i).user;
+        index->ranks[i] = g_array_index(collation, USER_COLLATION, i).rank;
+    }
+    g_array_free(collation, TRUE);
+    return index;
+}
+
 // Function to free the memory used by the hash table and its contents
 /**
  * @brief Frees the memory used by the hash table and its contents.
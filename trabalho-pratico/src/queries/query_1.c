@@ -9,8 +9,6 @@
 #include "validation.h"
 #include "utils.h"
 
-#include <ctype.h>
-
 // query_1 retorna as informações do utilizador com o username "username" ou as informações do voo com o id "id" ou as informações da reserva com o id "id"
 // JéssiTavares910 > retorna da tabela de hash o valor associado à chave "JéssiTavares910" as informações do utilizador com o username "JéssiTavares910" (ex: "Jéssica Tavares;F;63;PT;ZE466021;11;5;2365.200")
 // F JéssiTavares910 (isto é, tem format_flags, format_flags = 1) > retorna:
@@ -38,15 +36,10 @@ total_spent: 2365.200
  * @return char* The result string.
  */
 char* query_1(CATALOG *c, int format_flag, char **args, int args_size) {
-    char *result = g_malloc(sizeof(char) * MAX_RES_SIZE);
-    if (result == NULL) {
-        // Handle memory allocation failure
-        return NULL;
-    }
+    // the result is allocated with the size of the information (the names have no maximum length), an empty string if nothing is found
+    char *result = NULL;
     // Number of register
     int number_of_register = 1;
-    // Ensure that the result buffer is initialized before using it
-    result[0] = '\0'; // Set the first character to null terminator
     if (args_size == 1) { // só temos o user_id, ou id do voo, ou id da reserva
         // vamos procurar na hash table de users
         USER *user = g_hash_table_lookup(c->users, args[0]);
@@ -58,18 +51,20 @@ char* query_1(CATALOG *c, int format_flag, char **args, int args_size) {
                 RESERVATION *reservation = g_hash_table_lookup(c->reservations, args[0]);
                 // se não encontrarmos na hash table de reservations, retornamos uma string vazia
                 if (reservation == NULL) {
-                    return result;
+                    return g_strdup("");
                 } else {
                     // retornamos a informação da reserva "reservation";
                     // "hotel_id;hotel_name;hotel_stars;begin_date;end_date;includes_breakfast;nights;total_price"
                     int nights = calculate_nights(reservation->begin_date, reservation->end_date);
-                    double total_price = calculate_total_price(reservation->price_per_night, nights, atoi(reservation->city_tax));
-                    // include_breakfast first letter to uppercase
-                    reservation->includes_breakfast[0] = toupper(reservation->includes_breakfast[0]);
+                    double total_price = calculate_total_price(reservation->price_per_night, nights, reservation->city_tax);
+                    char begin_date[DATE_STRING_SIZE], end_date[DATE_STRING_SIZE];
+                    formatDate(reservation->begin_date, DATE_ONLY, begin_date);
+                    formatDate(reservation->end_date, DATE_ONLY, end_date);
+                    const char *includes_breakfast = reservation->includes_breakfast == BREAKFAST_INCLUDED ? "True" : "False";
                     if (format_flag) {
-                        sprintf(result, "--- %d ---\nhotel_id: %s\nhotel_name: %s\nhotel_stars: %s\nbegin_date: %s\nend_date: %s\nincludes_breakfast: %s\nnights: %d\ntotal_price: %.3f\n", number_of_register, reservation->hotel_id, reservation->hotel_name, reservation->hotel_stars, reservation->begin_date, reservation->end_date, reservation->includes_breakfast, nights, total_price);
+                        result = g_strdup_printf("--- %d ---\nhotel_id: %s\nhotel_name: %s\nhotel_stars: %d\nbegin_date: %s\nend_date: %s\nincludes_breakfast: %s\nnights: %d\ntotal_price: %.3f\n", number_of_register, reservation->hotel_id, reservation->hotel_name, reservation->hotel_stars, begin_date, end_date, includes_breakfast, nights, total_price);
                     } else { // if theres no format flag, we return the string as it is
-                        sprintf(result, "%s;%s;%s;%s;%s;%s;%d;%.3f\n", reservation->hotel_id, reservation->hotel_name, reservation->hotel_stars, reservation->begin_date, reservation->end_date, reservation->includes_breakfast, nights, total_price);
+                        result = g_strdup_printf("%s;%s;%d;%s;%s;%s;%d;%.3f\n", reservation->hotel_id, reservation->hotel_name, reservation->hotel_stars, begin_date, end_date, includes_breakfast, nights, total_price);
                     }
                     number_of_register++;
                 }
@@ -78,25 +73,28 @@ char* query_1(CATALOG *c, int format_flag, char **args, int args_size) {
                 // "airline;plane_model;origin;destination;schedule_departure_date;schedule_arrival_date;passengers;delay"
                 int flight_passengers = get_flight_passengers(c->passengers, flight->id);
                 int delay = calculate_delay(flight->schedule_departure_date, flight->real_departure_date);
+                char schedule_departure_date[DATE_STRING_SIZE], schedule_arrival_date[DATE_STRING_SIZE];
+                formatDate(flight->schedule_departure_date, DATE_TIME, schedule_departure_date);
+                formatDate(flight->schedule_arrival_date, DATE_TIME, schedule_arrival_date);
                 if (format_flag) {
-                    sprintf(result, "--- %d ---\nairline: %s\nplane_model: %s\norigin: %s\ndestination: %s\nschedule_departure_date: %s\nschedule_arrival_date: %s\npassengers: %d\ndelay: %d\n", number_of_register, flight->airline, flight->plane_model, flight->origin, flight->destination, flight->schedule_departure_date, flight->schedule_arrival_date, flight_passengers, delay);
+                    result = g_strdup_printf("--- %d ---\nairline: %s\nplane_model: %s\norigin: %s\ndestination: %s\nschedule_departure_date: %s\nschedule_arrival_date: %s\npassengers: %d\ndelay: %d\n", number_of_register, flight->airline, flight->plane_model, flight->origin, flight->destination, schedule_departure_date, schedule_arrival_date, flight_passengers, delay);
                 } else { // if theres no format flag, we return the string as it is
-                    sprintf(result, "%s;%s;%s;%s;%s;%s;%d;%d\n", flight->airline, flight->plane_model, flight->origin, flight->destination, flight->schedule_departure_date, flight->schedule_arrival_date, flight_passengers, delay);
+                    result = g_strdup_printf("%s;%s;%s;%s;%s;%s;%d;%d\n", flight->airline, flight->plane_model, flight->origin, flight->destination, schedule_departure_date, schedule_arrival_date, flight_passengers, delay);
                 }
                 number_of_register++;
             }
         } else {
             // "Não deverão ser retornadas informações para utilizadores com account_status = “inactive”"
-            if (isActive(user->account_status) == 0) return result;
+            if (user->account_status != ACCOUNT_ACTIVE) return g_strdup("");
             // retornamos a informação do user "user";
             // "user_id;sex;age;country_code;passport;number_of_flights;number_of_reservations;total_spent"
             int age = calculate_age(user->birth_date);
             // for number_of_flights we go to passengers hash table and count the number of passengers with the same user_id
-            int number_of_flights = count_number_flights(c->passengers, user->id);
+            int number_of_flights = count_number_flights(c, user->id);
             // for number_of_reservations we go to reservations hash table and count the number of reservations with the same user_id
-            int number_of_reservations = count_number_reservations(c->reservations, user->id);
+            int number_of_reservations = count_number_reservations(c, user->id);
             // for total_spent we go to reservations hash table and sum the total price of the reservations with the same user_id
-            double total_spent = calculate_total_spent(c->reservations, user->id);
+            double total_spent = calculate_total_spent(c, user->id);
             /*printf("UserID: %s\n", user->id);
             printf("Age: %d\n", age);
             printf("Number of flights: %d\n", number_of_flights);
@@ -110,12 +108,12 @@ char* query_1(CATALOG *c, int format_flag, char **args, int args_size) {
                 sex: (value)
                 age: (value)
                 */
-                sprintf(result, "--- %d ---\nname: %s\nsex: %s\nage: %d\ncountry_code: %s\npassport: %s\nnumber_of_flights: %d\nnumber_of_reservations: %d\ntotal_spent: %.3f\n", number_of_register, user->name, user->sex, age, user->country_code, user->passport, number_of_flights, number_of_reservations, total_spent);
+                result = g_strdup_printf("--- %d ---\nname: %s\nsex: %c\nage: %d\ncountry_code: %s\npassport: %s\nnumber_of_flights: %d\nnumber_of_reservations: %d\ntotal_spent: %.3f\n", number_of_register, user->name, user->sex, age, user->country_code, user->passport, number_of_flights, number_of_reservations, total_spent);
             } else { // if theres no format flag, we return the string as it is
-                sprintf(result, "%s;%s;%d;%s;%s;%d;%d;%.3f\n", user->name, user->sex, age, user->country_code, user->passport, number_of_flights, number_of_reservations, total_spent);
+                result = g_strdup_printf("%s;%c;%d;%s;%s;%d;%d;%.3f\n", user->name, user->sex, age, user->country_code, user->passport, number_of_flights, number_of_reservations, total_spent);
             }
             number_of_register++;
         }
     }
-    return result;
+    return result != NULL ? result : g_strdup("");
 }
\ No newline at end of file
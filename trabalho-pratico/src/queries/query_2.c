@@ -21,106 +21,27 @@ Input and Output:
 > 2 <ID> [flights|reservations]
 id;date[;type]
 */
-// Function to compare two users data for sorting (without format_flag)
-/**
- * @brief Function to compare two users data for sorting (without format_flag).
- * 
- * @param a The first user data.
- * @param b The second user data.
- * @return gint The comparator (0 if equal, > 0 if a > b, < 0 if a < b).
-*/
-static gint compare_userdata(gconstpointer a, gconstpointer b) {
-    int comparator = 0;
-
-    char *user_a = (char *)a;
-    char *user_b = (char *)b;
-
-    //printf("Comparing %s with %s\n", user_a, user_b);
-
-    // split string into tokens using g_strsplit
-    char **user_a_tokens = g_strsplit(user_a, ";", 0);
-    char **user_b_tokens = g_strsplit(user_b, ";", 0);
-
-    // get the date and id from the tokens
-    char *user_a_date = user_a_tokens[1];
-    char *user_b_date = user_b_tokens[1];
-
-    char *user_a_id = user_a_tokens[0];
-    char *user_b_id = user_b_tokens[0];
-
-    // compare the date
-    int date_cmp = date_comparator_wt(user_a_date, user_b_date);
-    if (date_cmp == 0) {
-        // if theres a tie, compare the id
-        comparator = -strcmp(user_a_id, user_b_id);
-    } else {
-        comparator = date_cmp;
-    }
-
-    // reverse the order of the comparison to sort in descending order
-    comparator *= -1;
-
-    // free the tokens
-    g_strfreev(user_a_tokens);
-    g_strfreev(user_b_tokens);
+// a flight or a reservation of the user, the line of the result is only formatted after the rows are sorted
+typedef struct query_2_row {
+    DATETIME date; // schedule_departure_date or begin_date (only the date is compared and presented)
+    const char *id;
+    const char *type; // "flight" or "reservation"
+} QUERY_2_ROW;
 
-    return comparator;
-}
-
-// Function to compare two users data for sorting (with format_flag)
 /**
- * @brief Function to compare two users data for sorting (with format_flag).
+ * @brief Compares two rows by date (most recent first) and id (for qsort).
  * 
- * @param a The first user data.
- * @param b The second user data.
- * @return gint The comparator (0 if equal, > 0 if a > b, < 0 if a < b).
+ * @param a The first row (QUERY_2_ROW*).
+ * @param b The second row (QUERY_2_ROW*).
+ * @return int The comparator (< 0 if a comes first).
 */
-static gint compare_userdata_format(gconstpointer a, gconstpointer b) {
-    int comparator = 0;
-
-    char *user_a = (char *)a;
-    char *user_b = (char *)b;
-
-    //printf("Comparing %s with %s\n", user_a, user_b);
-
-    // split string into tokens using g_strsplit
-    char **user_a_tokens = g_strsplit(user_a, "\n", 0);
-    char **user_b_tokens = g_strsplit(user_b, "\n", 0);
-
-    // get the date and id from the tokens
-    char **user_a_date_tokens = g_strsplit(user_a_tokens[1], ": ", 0);
-    char **user_b_date_tokens = g_strsplit(user_b_tokens[1], ": ", 0);
-
-    char *user_a_date = user_a_date_tokens[1];
-    char *user_b_date = user_b_date_tokens[1];
-
-    char **user_a_id_tokens = g_strsplit(user_a_tokens[0], ": ", 0);
-    char **user_b_id_tokens = g_strsplit(user_b_tokens[0], ": ", 0);
-
-    char *user_a_id = user_a_id_tokens[1];
-    char *user_b_id = user_b_id_tokens[1];
-
-    // compare the date
-    int date_cmp = date_comparator_wt(user_a_date, user_b_date);
-    if (date_cmp == 0) {
-        // if theres a tie, compare the id
-        comparator = -strcmp(user_a_id, user_b_id);
-    } else {
-        comparator = date_cmp;
+static int compare_rows(const void *a, const void *b) {
+    const QUERY_2_ROW *row_a = (const QUERY_2_ROW *) a;
+    const QUERY_2_ROW *row_b = (const QUERY_2_ROW *) b;
+    if (DATETIME_DATE(row_a->date) != DATETIME_DATE(row_b->date)) {
+        return DATETIME_DATE(row_a->date) < DATETIME_DATE(row_b->date) ? 1 : -1;
     }
-
-    // reverse the order of the comparison to sort in descending order
-    comparator *= -1;
-
-    // free the tokens
-    g_strfreev(user_a_tokens);
-    g_strfreev(user_b_tokens);
-    g_strfreev(user_a_date_tokens);
-    g_strfreev(user_b_date_tokens);
-    g_strfreev(user_a_id_tokens);
-    g_strfreev(user_b_id_tokens);
-
-    return comparator;
+    return strcmp(row_a->id, row_b->id);
 }
 
 /**
@@ -130,195 +51,62 @@ static gint compare_userdata_format(gconstpointer a, gconstpointer b) {
  * @param format_flag The format flag. @see command_interpreter
  * @param args The arguments. @see command_interpreter
  * @param args_size The size of the arguments. @see command_interpreter
- * @param resList The result list.
+ * @param result The result buffer (the flights and reservations are added to it).
  */
-void query_2(CATALOG *c, int format_flag, char **args, int args_size, GList **resList) {
-    *resList = NULL;
-
-    // create two lists, one for flights and one for reservations
-    GList *flightsList = NULL;
-    GList *reservationsList = NULL;
-
+void query_2(CATALOG *c, int format_flag, char **args, int args_size, RESULT_BUFFER *result) {
     if (args_size < 1) {
         return; // Handle missing arguments
     }
 
-    if (args_size == 1) { // we have the user_id and need to get the information for flights and reservations (and add ;flights or ;reservations where we found that data)
-        // get the user
+    // with only the user_id, the flights and the reservations are both listed (with their type)
+    int with_flights = args_size == 1;
+    int with_reservations = args_size == 1;
+    if (args_size == 1) {
         USER *user = g_hash_table_lookup(c->users, args[0]);
-        // if we dont find the user we return
-        if (user == NULL) return;
-        // if the user is inactive we return
-        if (isActive(user->account_status) == 0) return;
-        // get the flights and reservations
-        int number_of_flights = count_number_flights(c->passengers, args[0]);
-        char** flights = get_user_flights(c->passengers, args[0]);
-        int number_of_reservations = count_number_reservations(c->reservations, args[0]);
-        char** reservations = get_user_reservations(c->reservations, args[0]);
-        // iterate through the flights and reservations and add them to the list
-        for (int i = 0; i < number_of_flights; i++) {
-            // add the flight and date to the list
-            FLIGHT *flight = g_hash_table_lookup(c->flights, flights[i]);
-            if (flight == NULL) continue;
-            char *str = NULL;
-            char* formated_date = g_strdup(flight->schedule_departure_date);
-            // remove the time from the date
-            char *formated_date_token = strtok(formated_date, " ");
-            if (format_flag) {
-                char *str_format = "id: %s\ndate: %s\ntype: flight\n\n";
-                int len = snprintf(NULL, 0, str_format, flight->id, formated_date_token);
-                str = g_malloc(len + 1);
-                snprintf(str, len + 1, str_format, flight->id, formated_date_token);
-            } else {
-                char *str_format = "%s;%s;flight\n";
-                int len = snprintf(NULL, 0, str_format, flight->id, formated_date_token);
-                str = g_malloc(len + 1);
-                snprintf(str, len + 1, str_format, flight->id, formated_date_token);
-            }
-            flightsList = g_list_append(flightsList, str);
-            g_free(flights[i]);
-            // free the copy of the string
-            g_free(formated_date);
-        }
-        for (int i = 0; i < number_of_reservations; i++) {
-            // add the reservation and date to the list
-            RESERVATION *reservation = g_hash_table_lookup(c->reservations, reservations[i]);
-            if (reservation == NULL) continue;
-            char *str = NULL;
-            if (format_flag) {
-                char *str_format = "id: %s\ndate: %s\ntype: reservation\n\n";
-                int len = snprintf(NULL, 0, str_format, reservation->id, reservation->begin_date);
-                str = g_malloc(len + 1);
-                snprintf(str, len + 1, str_format, reservation->id, reservation->begin_date);
-            } else {
-                char *str_format = "%s;%s;reservation\n";
-                int len = snprintf(NULL, 0, str_format, reservation->id, reservation->begin_date);
-                str = g_malloc(len + 1);
-                snprintf(str, len + 1, str_format, reservation->id, reservation->begin_date);
-            }
-            reservationsList = g_list_append(reservationsList, str);
-            g_free(reservations[i]);
-        }
-        g_free(flights);
-        g_free(reservations);
-
-        // add to the list the flights and reservations
-        *resList = g_list_concat(flightsList, reservationsList);
-
-        // after having all the data we sort the list
-        if (format_flag) {
-            // if theres a format flag we sort but the "--- %d ---\n" must be added to the string after sorting them so "--- 1 ---" if always the first line and so on, but the data inside is sorted
-            *resList = g_list_sort(*resList, (GCompareFunc)compare_userdata_format);
-            // after sort we add the "--- %d ---\n" to the string
-            GList *iterList = *resList;
-            int number_of_results = 0;
-            while (iterList != NULL) {
-                char *userStr = iterList->data;
-                char *str = "--- %d ---\n%s";
-                int len = snprintf(NULL, 0, str, number_of_results + 1, userStr);
-                char *userStrFormatted = g_malloc(len + 1);
-                // if it is the last line, we remove the \n
-                if (iterList->next == NULL) {
-                    snprintf(userStrFormatted, len + 1, str, number_of_results + 1, userStr);
-                    userStrFormatted[len - 1] = '\0';
-                } else {
-                    snprintf(userStrFormatted, len + 1, str, number_of_results + 1, userStr);
-                }
-                g_free(userStr);
-                iterList->data = userStrFormatted;
-                iterList = g_list_next(iterList);
-                number_of_results++;
-            }
-        } else {
-            *resList = g_list_sort(*resList, (GCompareFunc)compare_userdata);
-        }
-    } else { // we have 2 args, the user_id and the hash table where we want to take the data from (only show the data)
-        if (strcmp(args[1], "flights") == 0) {
-            int number_of_flights = count_number_flights(c->passengers, args[0]);
-            char** flights = get_user_flights(c->passengers, args[0]);
-            for (int i = 0; i < number_of_flights; i++) {
-                // add the flight and date to the list
-                FLIGHT *flight = g_hash_table_lookup(c->flights, flights[i]);
-                if (flight == NULL) continue;
-                char *str = NULL;
-                //char* formated_date = strtok(flight->schedule_departure_date, " ");
-                // create a copy of the string so we dont modify the original
-                char *formated_date = g_strdup(flight->schedule_departure_date);
-                // remove the time from the date
-                char *formated_date_token = strtok(formated_date, " ");
-                if (format_flag) {
-                    char *str_format = "id: %s\ndate: %s\n\n";
-                    int len = snprintf(NULL, 0, str_format, flight->id, formated_date_token);
-                    str = g_malloc(len + 1);
-                    snprintf(str, len + 1, str_format, flight->id, formated_date_token);
-                } else {
-                    char *str_format = "%s;%s\n";
-                    int len = snprintf(NULL, 0, str_format, flight->id, formated_date_token);
-                    str = g_malloc(len + 1);
-                    snprintf(str, len + 1, str_format, flight->id, formated_date_token);
-                }
-                flightsList = g_list_append(flightsList, str);
-                g_free(flights[i]);
-                // free the copy of the string
-                g_free(formated_date);
-            }
-            g_free(flights);
-        } else if (strcmp(args[1], "reservations") == 0) {
-            int number_of_reservations = count_number_reservations(c->reservations, args[0]);
-            char** reservations = get_user_reservations(c->reservations, args[0]);
-            for (int i = 0; i < number_of_reservations; i++) {
-                // add the reservation and date to the list
-                RESERVATION *reservation = g_hash_table_lookup(c->reservations, reservations[i]);
-                if (reservation == NULL) continue;
-                char *str = NULL;
-                if (format_flag) {
-                    char *str_format = "id: %s\ndate: %s\n\n";
-                    int len = snprintf(NULL, 0, str_format, reservation->id, reservation->begin_date);
-                    str = g_malloc(len + 1);
-                    snprintf(str, len + 1, str_format, reservation->id, reservation->begin_date);
-                } else {
-                    char *str_format = "%s;%s\n";
-                    int len = snprintf(NULL, 0, str_format, reservation->id, reservation->begin_date);
-                    str = g_malloc(len + 1);
-                    snprintf(str, len + 1, str_format, reservation->id, reservation->begin_date);
-                }
-                reservationsList = g_list_append(reservationsList, str);
-                g_free(reservations[i]);
-            }
-            g_free(reservations);
-        } else {
-            return; // Handle invalid arguments
-        }
+        // if we dont find the user or the user is inactive we return
+        if (user == NULL || user->account_status != ACCOUNT_ACTIVE) return;
+    } else if (strcmp(args[1], "flights") == 0) {
+        with_flights = 1;
+    } else if (strcmp(args[1], "reservations") == 0) {
+        with_reservations = 1;
+    } else {
+        return; // Handle invalid arguments
+    }
 
-        // add to the list the flights and reservations
-        *resList = g_list_concat(flightsList, reservationsList);
+    // the flights and reservations come from the indexes by user
+    int number_of_flights = 0;
+    FLIGHT **flights = with_flights ? get_catalog_user_flights(c, args[0], &number_of_flights) : NULL;
+    USER_RESERVATIONS *user_reservations = with_reservations ? get_catalog_user_reservations(c, args[0]) : NULL;
+    int number_of_reservations = user_reservations != NULL ? user_reservations->total_reservations : 0;
+    int total_rows = number_of_flights + number_of_reservations;
+    if (total_rows == 0) {
+        return;
+    }
 
-        // after having all the data we sort the list
-        if (format_flag) {
-            // if theres a format flag we sort but the "--- %d ---\n" must be added to the string after sorting them so "--- 1 ---" if always the first line and so on, but the data inside is sorted
-            *resList = g_list_sort(*resList, (GCompareFunc)compare_userdata_format);
-            // after sort we add the "--- %d ---\n" to the string
-            GList *iterList = *resList;
-            int number_of_results = 0;
-            while (iterList != NULL) {
-                char *userStr = iterList->data;
-                char *str = "--- %d ---\n%s";
-                int len = snprintf(NULL, 0, str, number_of_results + 1, userStr);
-                char *userStrFormatted = g_malloc(len + 1);
-                // if it is the last line, we remove the \n
-                if (iterList->next == NULL) {
-                    snprintf(userStrFormatted, len + 1, str, number_of_results + 1, userStr);
-                    userStrFormatted[len - 1] = '\0';
-                } else {
-                    snprintf(userStrFormatted, len + 1, str, number_of_results + 1, userStr);
-                }
-                g_free(userStr);
-                iterList->data = userStrFormatted;
-                iterList = g_list_next(iterList);
-                number_of_results++;
+    QUERY_2_ROW *rows = g_new(QUERY_2_ROW, total_rows);
+    for (int i = 0; i < number_of_flights; i++) {
+        rows[i] = (QUERY_2_ROW) { flights[i]->schedule_departure_date, flights[i]->id, "flight" };
+    }
+    for (int i = 0; i < number_of_reservations; i++) {
+        RESERVATION *reservation = user_reservations->reservations[i];
+        rows[number_of_flights + i] = (QUERY_2_ROW) { reservation->begin_date, reservation->id, "reservation" };
+    }
+    qsort(rows, total_rows, sizeof(QUERY_2_ROW), compare_rows);
+
+    for (int i = 0; i < total_rows; i++) {
+        char date[DATE_STRING_SIZE];
+        formatDate(rows[i].date, DATE_ONLY, date);
+        if (format_flag) { // "--- 1 ---\nid: id\ndate: date[\ntype: type]\n\n", the last one without the final \n
+            if (args_size == 1) {
+                result_buffer_printf(result, "--- %d ---\nid: %s\ndate: %s\ntype: %s\n%s", i + 1, rows[i].id, date, rows[i].type, i == total_rows - 1 ? "" : "\n");
+            } else {
+                result_buffer_printf(result, "--- %d ---\nid: %s\ndate: %s\n%s", i + 1, rows[i].id, date, i == total_rows - 1 ? "" : "\n");
             }
+        } else if (args_size == 1) {
+            result_buffer_printf(result, "%s;%s;%s\n", rows[i].id, date, rows[i].type);
         } else {
-            *resList = g_list_sort(*resList, (GCompareFunc)compare_userdata);
+            result_buffer_printf(result, "%s;%s\n", rows[i].id, date);
         }
     }
-}
\ No newline at end of file
+    g_free(rows);
+}
@@ -31,20 +31,13 @@ char* query_3(CATALOG *c, int format_flag, char **args, int args_size) {
     int count = 0;
 
     if (args_size == 1) {
-        // get the reservation->hotel_id
-        // we cant use g_hash_table_lookup because we dont have the reservation id we need reservation->hotel_id
-        // so we have to iterate through the hash table if the reservation->hote_id == args[0] we add reservation->stars to the average
-        // in the end we divide the average by the number of lines that we found with the same hotel_id (count)
-        GHashTableIter iter;
-        gpointer key, value;
-        g_hash_table_iter_init(&iter, c->reservations);
-
-        while (g_hash_table_iter_next(&iter, &key, &value)) {
-            RESERVATION *reservation = (RESERVATION *)value;
-            if (strcmp(reservation->hotel_id, args[0]) == 0) {
-                average_rating += atof(reservation->rating);
-                count++;
+        // the reservations of the hotel come from the catalog index (instead of going through all the reservations)
+        HOTEL_RESERVATIONS *hotel_reservations = get_catalog_hotel_reservations(c, args[0]);
+        if (hotel_reservations != NULL) {
+            for (int i = 0; i < hotel_reservations->total_reservations; i++) {
+                average_rating += hotel_reservations->reservations[i]->rating;
             }
+            count = hotel_reservations->total_reservations;
         }
         if (count == 0) return result;
         number_of_results++;
@@ -16,108 +16,6 @@ sua respetiva data estimada de partida esteja entre <begin_date> e <end_date> (a
 Caso dois voos tenham a mesma data, o identificador do voo deverá ser usado como critério de
 desempate (de forma crescente).
 */
-// Function to compare two flights departure date for sorting (without format_flag)
-/**
- * @brief Function to compare two flights departure date for sorting (without format_flag).
- * 
- * @param a The first flight departure date.
- * @param b The second flight departure date.
- * @return gint The comparator (0 if equal, > 0 if a > b, < 0 if a < b).
-*/
-static gint compare_flightdeparture(gconstpointer a, gconstpointer b) {
-    int comparator = 0;
-
-    char *flight_a = (char *)a;
-    char *flight_b = (char *)b;
-
-    //printf("Comparing %s with %s\n", flight_a, flight_b);
-
-    // split string into tokens using g_strsplit
-    char **flight_a_tokens = g_strsplit(flight_a, ";", 0);
-    char **flight_b_tokens = g_strsplit(flight_b, ";", 0);
-
-    // get the schedule_departure_date and id from the tokens
-    char *flight_a_schedule_departure_date = flight_a_tokens[1];
-    char *flight_b_schedule_departure_date = flight_b_tokens[1];
-
-    char *flight_a_id = flight_a_tokens[0];
-    char *flight_b_id = flight_b_tokens[0];
-
-    // compare the schedule_departure_date
-    int schedule_departure_date_cmp = date_comparator(flight_a_schedule_departure_date, flight_b_schedule_departure_date);
-    if (schedule_departure_date_cmp == 0) {
-        // if theres a tie, compare the id
-        comparator = -strcmp(flight_a_id, flight_b_id);
-    } else {
-        comparator = schedule_departure_date_cmp;
-    }
-
-    // reverse the order of the comparison to sort in descending order
-    comparator *= -1;
-
-    // free the tokens
-    g_strfreev(flight_a_tokens);
-    g_strfreev(flight_b_tokens);
-
-    return comparator;
-}
-
-// Function to compare two flights departure date for sorting (with format_flag)
-/**
- * @brief Function to compare two flights departure date for sorting (with format_flag).
- * 
- * @param a The first flight departure date.
- * @param b The second flight departure date.
- * @return gint The comparator (0 if equal, > 0 if a > b, < 0 if a < b).
-*/
-static gint compare_flightdeparture_format(gconstpointer a, gconstpointer b) {
-    int comparator = 0;
-
-    char *flight_a = (char *)a;
-    char *flight_b = (char *)b;
-
-    //printf("Comparing %s with %s\n", flight_a, flight_b);
-
-    // split string into tokens using g_strsplit
-    char **flight_a_tokens = g_strsplit(flight_a, "\n", 0);
-    char **flight_b_tokens = g_strsplit(flight_b, "\n", 0);
-
-    // get the schedule_departure_date and id from the tokens
-    char **flight_a_schedule_departure_date_tokens = g_strsplit(flight_a_tokens[1], ": ", 0);
-    char **flight_b_schedule_departure_date_tokens = g_strsplit(flight_b_tokens[1], ": ", 0);
-
-    char *flight_a_schedule_departure_date = flight_a_schedule_departure_date_tokens[1];
-    char *flight_b_schedule_departure_date = flight_b_schedule_departure_date_tokens[1];
-
-    char **flight_a_id_tokens = g_strsplit(flight_a_tokens[0], ": ", 0);
-    char **flight_b_id_tokens = g_strsplit(flight_b_tokens[0], ": ", 0);
-
-    char *flight_a_id = flight_a_id_tokens[1];
-    char *flight_b_id = flight_b_id_tokens[1];
-
-    // compare the schedule_departure_date
-    int schedule_departure_date_cmp = date_comparator(flight_a_schedule_departure_date, flight_b_schedule_departure_date);
-    if (schedule_departure_date_cmp == 0) {
-        // if theres a tie, compare the id
-        comparator = -strcmp(flight_a_id, flight_b_id);
-    } else {
-        comparator = schedule_departure_date_cmp;
-    }
-
-    // reverse the order of the comparison to sort in descending order
-    comparator *= -1;
-
-    // free the tokens
-    g_strfreev(flight_a_tokens);
-    g_strfreev(flight_b_tokens);
-    g_strfreev(flight_a_schedule_departure_date_tokens);
-    g_strfreev(flight_b_schedule_departure_date_tokens);
-    g_strfreev(flight_a_id_tokens);
-    g_strfreev(flight_b_id_tokens);
-
-    return comparator;
-}
-
 /**
  * @brief Returns the flights with origin in a given airport, between two dates, ordered by estimated departure date (from most recent to oldest). A flight is between <begin_date> and <end_date> if its respective estimated departure date is between <begin_date> and <end_date> (both inclusive). If two flights have the same date, the flight identifier should be used as a tiebreaker (in ascending order).
  * 
@@ -125,82 +23,61 @@ static gint compare_flightdeparture_format(gconstpointer a, gconstpointer b) {
  * @param format_flag The format flag. @see command_interpreter
  * @param args The arguments. @see command_interpreter
  * @param args_size The size of the arguments. @see command_interpreter
- * @param resList The result list.
+ * @param result The result buffer (the flights are added to it).
  */
-void query_5(CATALOG *c, int format_flag, char **args, int args_size, GList **resList) {
-    *resList = NULL;
-
+void query_5(CATALOG *c, int format_flag, char **args, int args_size, RESULT_BUFFER *result) {
     if (args_size < 3) {
         return;
     }
 
-    char *airport_name = args[0];
-    char *begin_date = args[1];
-    char *end_date = args[2];
-
-    // iterate through the flights hash table
-    GHashTableIter iter;
-    gpointer key, value;
-    g_hash_table_iter_init(&iter, c->flights);
+    // the dates are parsed once (only the dates are compared, without the time)
+    DATETIME begin_date, end_date;
+    scanDate(args[1], &begin_date);
+    scanDate(args[2], &end_date);
+    begin_date = DATETIME_DATE(begin_date);
+    end_date = DATETIME_DATE(end_date);
 
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        FLIGHT *flight = (FLIGHT *)value;
-        // check if the flight is from the airport_name
-        // but both strings to uppercase so we dont have to worry about case sensitivity
-        char *airport_name_upper = toupper_str(airport_name);
-        char *flight_origin_upper = toupper_str(flight->origin);
-        char *flight_destination_upper = toupper_str(flight->destination);
-        if (strcmp(flight_origin_upper, airport_name_upper) == 0) {
-            // check if the flight is between begin_date and end_date
-            if (date_comparator_wt(flight->schedule_departure_date, begin_date) >= 0 && date_comparator_wt(flight->schedule_arrival_date, end_date) <= 0) {
-                char* flightStr = NULL;
-
-                if (format_flag) { // Format the output
-                    char *str = "id: %s\nschedule_departure_date: %s\ndestination: %s\nairline: %s\nplane_model: %s\n\n";
-                    int len = snprintf(NULL, 0, str, flight->id, flight->schedule_departure_date, flight_destination_upper, flight->airline, flight->plane_model);
-                    flightStr = g_malloc(len + 1);
-                    snprintf(flightStr, len + 1, str, flight->id, flight->schedule_departure_date, flight_destination_upper, flight->airline, flight->plane_model);
-                } else {
-                    char *str = "%s;%s;%s;%s;%s\n";
-                    int len = snprintf(NULL, 0, str, flight->id, flight->schedule_departure_date, flight_destination_upper, flight->airline, flight->plane_model);
-                    flightStr = g_malloc(len + 1);
-                    snprintf(flightStr, len + 1, str, flight->id, flight->schedule_departure_date, flight_destination_upper, flight->airline, flight->plane_model);
-                }
+    // the flights of the airport come from the catalog index, already sorted by schedule_departure_date (most recent first) and id
+    AIRPORT_FLIGHTS *origin_flights = get_catalog_origin_flights(c, args[0]);
+    if (origin_flights == NULL) {
+        return;
+    }
 
-                *resList = g_list_append(*resList, flightStr);
-            }
+    // the flights in the window are found with two binary searches: the first one that departs before the end of the window
+    // (first = first flight with departure date <= end_date) and the first one that departs before its beginning (last = first flight with departure date < begin_date)
+    int first = 0, high = origin_flights->total_flights;
+    while (first < high) {
+        int middle = first + (high - first) / 2;
+        if (DATETIME_DATE(origin_flights->flights[middle]->schedule_departure_date) > end_date) {
+            first = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    int last = first;
+    high = origin_flights->total_flights;
+    while (last < high) {
+        int middle = last + (high - last) / 2;
+        if (DATETIME_DATE(origin_flights->flights[middle]->schedule_departure_date) >= begin_date) {
+            last = middle + 1;
+        } else {
+            high = middle;
         }
-        // free the strings (because we used toupper_str and it uses strdup)
-        g_free(airport_name_upper);
-        g_free(flight_origin_upper);
-        g_free(flight_destination_upper);
     }
 
-    // Sort the list based on schedule_departure_date and id
-    if (format_flag) {
-        // if theres a format flag we sort but the "--- %d ---\n" must be added to the string after sorting them so "--- 1 ---" if always the first line and so on, but the data inside is sorted
-        *resList = g_list_sort(*resList, (GCompareFunc)compare_flightdeparture_format);
-        // after sort we add the "--- %d ---\n" to the string
-        GList *iterList = *resList;
-        int number_of_results = 0;
-        while (iterList != NULL) {
-            char *flightStr = iterList->data;
-            char *str = "--- %d ---\n%s";
-            int len = snprintf(NULL, 0, str, number_of_results + 1, flightStr);
-            char *flightStrFormatted = g_malloc(len + 1);
-            // if it is the last line, we remove the \n
-            if (iterList->next == NULL) {
-                snprintf(flightStrFormatted, len + 1, str, number_of_results + 1, flightStr);
-                flightStrFormatted[len - 1] = '\0';
-            } else {
-                snprintf(flightStrFormatted, len + 1, str, number_of_results + 1, flightStr);
-            }
-            g_free(flightStr);
-            iterList->data = flightStrFormatted;
-            iterList = g_list_next(iterList);
-            number_of_results++;
+    for (int i = first; i < last; i++) {
+        FLIGHT *flight = origin_flights->flights[i];
+        char schedule_departure_date[DATE_STRING_SIZE];
+        formatDate(flight->schedule_departure_date, DATE_TIME, schedule_departure_date);
+        // the destination in upper case (toupper_str uses strdup)
+        char *flight_destination_upper = toupper_str(flight->destination);
+
+        if (format_flag) { // Format the output (the "--- %d ---\n" of each result, the last one without the final \n)
+            const char *separator = i == last - 1 ? "" : "\n";
+            result_buffer_printf(result, "--- %d ---\nid: %s\nschedule_departure_date: %s\ndestination: %s\nairline: %s\nplane_model: %s\n%s", i - first + 1, flight->id, schedule_departure_date, flight_destination_upper, flight->airline, flight->plane_model, separator);
+        } else {
+            result_buffer_printf(result, "%s;%s;%s;%s;%s\n", flight->id, schedule_departure_date, flight_destination_upper, flight->airline, flight->plane_model);
         }
-    } else {
-        *resList = g_list_sort(*resList, (GCompareFunc)compare_flightdeparture);
+        g_free(flight_destination_upper);
     }
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "statistics.h"
 #include "validation.h"
 #include "utils.h"
+#include "parsers/reservations.h"
 
 /*
 query_8: Apresentar a receita total de um hotel entre duas datas (inclusive), a partir do seu identificador.
@@ -17,29 +18,6 @@ de 2023/10/01 a 2023/10/10, e quisermos saber as receitas entre 2023/10/01 a 202
 retornado 200€ (duas noites). Por outro lado, caso a reserva seja entre 2023/10/01 a 2023/09/02,
 deverá ser retornado 100€ (uma noite).
 */
-// calculate_nights_i is the same as calculate_nights but it counts the nights between two dates (inclusive)
-/**
- * @brief Returns the number of nights between two dates (inclusive).
- * 
- * @param begin_date The begin date.
- * @param end_date The end date.
- * @return int The number of nights.
- */
-int calculate_nights_i(char *begin_date, char *end_date) {
-    return calculate_nights(begin_date, end_date) + 1;
-}
-// calculate_total_price_wt its the same as calculate_total_price but without the city_tax
-/**
- * @brief Returns the total price of a reservation.
- * 
- * @param price_per_night The price per night.
- * @param nights The number of nights.
- * @return int The total price.
- */
-int calculate_total_price_wt(char *price_per_night, int nights) {
-    return atoi(price_per_night) * nights;
-}
-
 /**
  * @brief Returns the total revenue of a hotel between two dates (inclusive), from its identifier.
  * 
@@ -55,42 +33,27 @@ char* query_8(CATALOG *c, int format_flag, char **args, int args_size) {
     result[0] = '\0';
 
     int number_of_results = 0;
-    int total_revenue = 0;
+    long long total_revenue = 0;
 
     if (args_size == 3) {
-        // get the reservation->hotel_id
-        // we cant use g_hash_table_lookup because we dont have the reservation id we need reservation->hotel_id
-        // so we have to iterate through the hash table if the reservation->hote_id == args[0] we add reservation->stars to the average
-        // in the end we divide the average by the number of lines that we found with the same hotel_id (count)
-        GHashTableIter iter;
-        gpointer key, value;
-        g_hash_table_iter_init(&iter, c->reservations);
-
-        while (g_hash_table_iter_next(&iter, &key, &value)) {
-            RESERVATION *reservation = (RESERVATION *)value;
-            if (strcmp(reservation->hotel_id, args[0]) == 0) {
-                // get all the reservations between the two dates (inclusive)
-                if (date_comparator_wt(args[1], reservation->begin_date) >= 0 && date_comparator_wt(args[2], reservation->end_date) <= 0) {
-                    int nights = calculate_nights_i(args[1], args[2]);
-                    total_revenue += calculate_total_price_wt(reservation->price_per_night, nights);
-                }
-                if (date_comparator_wt(args[1], reservation->begin_date) <= 0 && date_comparator_wt(args[2], reservation->end_date) >= 0) {
-                    int reservation_nights = calculate_nights_i(reservation->begin_date, reservation->end_date)-1; // we do -1 because if args[1] or args[2] are before or after the reservation->begin_date or reservation->end_date we dont want to count that night
-                    int nights = calculate_nights_i(args[1], args[2])-1;
-                    if (reservation_nights >= nights) {
-                        total_revenue += calculate_total_price_wt(reservation->price_per_night, nights);
-                    } else {
-                        total_revenue += calculate_total_price_wt(reservation->price_per_night, reservation_nights);
-                    }
-                }
-            }
+        // the dates are parsed once (only the days are used, without the time)
+        DATETIME begin_date, end_date;
+        int valid_dates = scanDate(args[1], &begin_date) != DATE_INVALID && scanDate(args[2], &end_date) != DATE_INVALID;
+        // the revenue comes from the prefix sums of the hotel in the catalog index: the revenue of the nights before the day after
+        // the window minus the revenue of the nights before the window (a reservation only counts the nights it has in the window)
+        HOTEL_RESERVATIONS *hotel_reservations = get_catalog_hotel_reservations(c, args[0]);
+        // the days are numbered like the nights of calculate_nights, so a reservation inside the window pays the nights of query 1 and 4
+        if (hotel_reservations != NULL && valid_dates && calculate_day_number(begin_date) <= calculate_day_number(end_date)) {
+            int first_day = calculate_day_number(begin_date);
+            int last_day = calculate_day_number(end_date);
+            total_revenue = hotel_revenue_before(&hotel_reservations->revenue, last_day + 1) - hotel_revenue_before(&hotel_reservations->revenue, first_day);
         }
         number_of_results++;
 
         if (format_flag) {
-            sprintf(result, "--- %d ---\nrevenue: %d\n", number_of_results, total_revenue);
+            sprintf(result, "--- %d ---\nrevenue: %lld\n", number_of_results, total_revenue);
         } else {
-            sprintf(result, "%d\n", total_revenue);
+            sprintf(result, "%lld\n", total_revenue);
         }
     }
     return result;
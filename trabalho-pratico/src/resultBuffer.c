@@ -0,0 +1,105 @@
+/**
+ * @file resultBuffer.c
+ * @brief Implementation of the result buffers (the lines of the result of a query, in a single growable buffer).
+ */
+#include "resultBuffer.h"
+
+#define RESULT_BUFFER_INITIAL_SIZE 1024 // initial size of the text of a result (GString doubles it when it is full)
+
+/**
+ * @brief Creates an empty result buffer.
+ *
+ * @return RESULT_BUFFER* The result buffer. @see struct RESULT_BUFFER
+ */
+RESULT_BUFFER *new_result_buffer(void) {
+    RESULT_BUFFER *result = g_new(RESULT_BUFFER, 1);
+    result->text = g_string_sized_new(RESULT_BUFFER_INITIAL_SIZE);
+    result->lines = g_array_new(FALSE, FALSE, sizeof(gsize));
+    return result;
+}
+
+/**
+ * @brief Adds a line to the end of a result.
+ *
+ * @param result The result buffer.
+ * @param line The line (copied to the buffer).
+ */
+void result_buffer_append(RESULT_BUFFER *result, const char *line) {
+    gsize start = result->text->len;
+    g_array_append_val(result->lines, start);
+    g_string_append(result->text, line);
+}
+
+/**
+ * @brief Adds a line to the end of a result, formatted like printf (directly in the buffer, without a temporary string).
+ *
+ * @param result The result buffer.
+ * @param format The printf format of the line.
+ * @param ... The values of the format.
+ */
+void result_buffer_printf(RESULT_BUFFER *result, const char *format, ...) {
+    gsize start = result->text->len;
+    g_array_append_val(result->lines, start);
+    va_list values;
+    va_start(values, format);
+    g_string_append_vprintf(result->text, format, values);
+    va_end(values);
+}
+
+/**
+ * @brief Gets the number of lines of a result.
+ *
+ * @param result The result buffer.
+ * @return int The number of lines.
+ */
+int result_buffer_size(RESULT_BUFFER *result) {
+    return (int) result->lines->len;
+}
+
+/**
+ * @brief Gets a line of a result (it is not followed by a '\0', except the last one).
+ *
+ * @param result The result buffer.
+ * @param index The index of the line (from 0 to result_buffer_size - 1).
+ * @param length Where the length of the line is saved.
+ * @return const char* The start of the line, only valid until a line is added to the result.
+ */
+const char *result_buffer_line(RESULT_BUFFER *result, int index, gsize *length) {
+    gsize start = g_array_index(result->lines, gsize, index);
+    gsize end = index + 1 < (int) result->lines->len ? g_array_index(result->lines, gsize, index + 1) : result->text->len;
+    *length = end - start;
+    return result->text->str + start;
+}
+
+/**
+ * @brief Writes all the lines of a result to a file.
+ *
+ * @param result The result buffer.
+ * @param file The file.
+ */
+void write_result_buffer(RESULT_BUFFER *result, FILE *file) {
+    fwrite(result->text->str, 1, result->text->len, file);
+}
+
+/**
+ * @brief Removes all the lines of a result (the buffer is kept, to be reused by the next result).
+ *
+ * @param result The result buffer.
+ */
+void clear_result_buffer(RESULT_BUFFER *result) {
+    g_string_truncate(result->text, 0);
+    g_array_set_size(result->lines, 0);
+}
+
+/**
+ * @brief Frees a result buffer.
+ *
+ * @param result The result buffer.
+ */
+void free_result_buffer(RESULT_BUFFER *result) {
+    if (result != NULL) {
+        g_string_free(result->text, TRUE);
+        g_array_free(result->lines, TRUE);
+        g_free(result);
+    }
+}
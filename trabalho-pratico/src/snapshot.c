@@ -0,0 +1,429 @@
+/**
+ * @file snapshot.c
+ * @brief Implementation of the catalog snapshots (save a validated catalog to a binary file and load it back).
+ */
+#include "snapshot.h"
+#include "structs.h"
+#include "mappedFile.h"
+#include "statistics.h"
+#include "parsers/reservations.h"
+#include "parsers/passengers.h"
+#include "parsers/flights.h"
+#include "parsers/users.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <glib.h>
+
+#define SNAPSHOT_WRITE_BUFFER_SIZE (1 << 20) // size of the stdio buffer used to write a snapshot
+
+typedef enum snapshot_string_kind {
+    STRING_UNIQUE, // a string only used by its record (saved once per record)
+    STRING_SHARED, // a string that can be shared by several records, like the user ids (saved once)
+    STRING_INTERNED // a shared string that is also in the catalog string pool (@see intern_string)
+} SNAPSHOT_STRING_KIND;
+
+typedef struct snapshot_string_field {
+    size_t offset; // offset of the (char*) field in the record
+    SNAPSHOT_STRING_KIND kind;
+} SNAPSHOT_STRING_FIELD;
+
+// the strings of each record (the interned ones are the ones interned by the parsers)
+static const SNAPSHOT_STRING_FIELD user_fields[] = {
+    { offsetof(USER, id), STRING_SHARED },
+    { offsetof(USER, name), STRING_UNIQUE },
+    { offsetof(USER, email), STRING_UNIQUE },
+    { offsetof(USER, phone_number), STRING_UNIQUE },
+    { offsetof(USER, passport), STRING_UNIQUE },
+    { offsetof(USER, country_code), STRING_INTERNED },
+    { offsetof(USER, address), STRING_UNIQUE },
+    { offsetof(USER, pay_method), STRING_INTERNED }
+};
+
+static const SNAPSHOT_STRING_FIELD flight_fields[] = {
+    { offsetof(FLIGHT, id), STRING_SHARED },
+    { offsetof(FLIGHT, airline), STRING_INTERNED },
+    { offsetof(FLIGHT, plane_model), STRING_INTERNED },
+    { offsetof(FLIGHT, origin), STRING_INTERNED },
+    { offsetof(FLIGHT, destination), STRING_INTERNED },
+    { offsetof(FLIGHT, pilot), STRING_UNIQUE },
+    { offsetof(FLIGHT, copilot), STRING_UNIQUE }
+};
+
+static const SNAPSHOT_STRING_FIELD reservation_fields[] = {
+    { offsetof(RESERVATION, id), STRING_UNIQUE },
+    { offsetof(RESERVATION, user_id), STRING_SHARED },
+    { offsetof(RESERVATION, hotel_id), STRING_INTERNED },
+    { offsetof(RESERVATION, hotel_name), STRING_INTERNED },
+    { offsetof(RESERVATION, address), STRING_INTERNED }
+};
+
+static const SNAPSHOT_STRING_FIELD flight_seats_fields[] = {
+    { offsetof(FLIGHT_SEATS, flight_id), STRING_SHARED }
+};
+
+#define FIELDS_COUNT(fields) ((int) (sizeof(fields) / sizeof(fields[0])))
+
+typedef struct snapshot_writer {
+    FILE *file;
+    GString *strings; // the strings section (written at the end of the file)
+    GHashTable *shared; // shared string (by pointer) -> its offset in the strings section
+} SNAPSHOT_WRITER;
+
+/**
+ * @brief Writes bytes to a snapshot file (exits if the write fails).
+ *
+ * @param writer The snapshot writer.
+ * @param data The bytes to write.
+ * @param size The number of bytes.
+ */
+static void write_snapshot_bytes(SNAPSHOT_WRITER *writer, const void *data, size_t size) {
+    if (fwrite(data, 1, size, writer->file) != size) {
+        perror("Error writing snapshot");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Adds a string to the strings section of a snapshot (a shared string is only added once).
+ *
+ * @param writer The snapshot writer.
+ * @param value The string (can be NULL).
+ * @param kind If the string can be shared by several records. @see enum SNAPSHOT_STRING_KIND
+ * @return guint64 The offset of the string in the strings section (0 if the string is NULL).
+ */
+static guint64 add_snapshot_string(SNAPSHOT_WRITER *writer, const char *value, SNAPSHOT_STRING_KIND kind) {
+    if (value == NULL) {
+        return 0;
+    }
+    if (kind != STRING_UNIQUE) {
+        guint64 offset = GPOINTER_TO_SIZE(g_hash_table_lookup(writer->shared, value));
+        if (offset != 0) {
+            return offset;
+        }
+    }
+    guint64 offset = writer->strings->len;
+    g_string_append_len(writer->strings, value, strlen(value) + 1);
+    if (kind != STRING_UNIQUE) {
+        g_hash_table_insert(writer->shared, (gpointer) value, GSIZE_TO_POINTER(offset));
+    }
+    return offset;
+}
+
+/**
+ * @brief Replaces the strings of a record (a copy of it) by their offsets in the strings section.
+ *
+ * @param writer The snapshot writer.
+ * @param record The copy of the record.
+ * @param fields The string fields of the record.
+ * @param fields_count The number of string fields.
+ */
+static void encode_snapshot_strings(SNAPSHOT_WRITER *writer, void *record, const SNAPSHOT_STRING_FIELD *fields, int fields_count) {
+    for (int i = 0; i < fields_count; i++) {
+        char **field = (char **) ((char *) record + fields[i].offset);
+        *field = (char *) (uintptr_t) add_snapshot_string(writer, *field, fields[i].kind);
+    }
+}
+
+/**
+ * @brief Gets the id of the user record with an id (so the references to a user share the user id string).
+ *
+ * @param users The users hash table.
+ * @param user_id The user id (e.g. a slice of the reservations file).
+ * @return char* The id of the user record, or the given id if there is no such user.
+ */
+static char *user_id_of(GHashTable *users, char *user_id) {
+    USER *user = g_hash_table_lookup(users, user_id);
+    return user != NULL ? user->id : user_id;
+}
+
+/**
+ * @brief Saves a catalog to a snapshot file. @see load_snapshot
+ *
+ * @param c The catalog (already loaded). @see load_catalog
+ * @param path The path of the snapshot file (it is replaced if it exists).
+ */
+void save_snapshot(CATALOG *c, const char *path) {
+    SNAPSHOT_WRITER writer;
+    writer.file = fopen(path, "wb");
+    if (writer.file == NULL) {
+        perror("Error opening snapshot");
+        exit(EXIT_FAILURE);
+    }
+    setvbuf(writer.file, NULL, _IOFBF, SNAPSHOT_WRITE_BUFFER_SIZE);
+    writer.strings = g_string_sized_new(SNAPSHOT_WRITE_BUFFER_SIZE);
+    writer.shared = g_hash_table_new(g_direct_hash, g_direct_equal);
+    // offset 0 is reserved for NULL
+    g_string_append_c(writer.strings, '\0');
+
+    SNAPSHOT_HEADER header;
+    memset(&header, 0, sizeof(SNAPSHOT_HEADER));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.header_size = sizeof(SNAPSHOT_HEADER);
+    header.record_sizes[0] = sizeof(USER);
+    header.record_sizes[1] = sizeof(FLIGHT);
+    header.record_sizes[2] = sizeof(RESERVATION);
+    header.record_sizes[3] = sizeof(FLIGHT_SEATS);
+    header.users.count = g_hash_table_size(c->users);
+    header.flights.count = g_hash_table_size(c->flights);
+    header.reservations.count = g_hash_table_size(c->reservations);
+    header.flight_seats.count = g_hash_table_size(c->passengers);
+    header.users.offset = sizeof(SNAPSHOT_HEADER);
+    header.flights.offset = header.users.offset + header.users.count * sizeof(USER);
+    header.reservations.offset = header.flights.offset + header.flights.count * sizeof(FLIGHT);
+    header.flight_seats.offset = header.reservations.offset + header.reservations.count * sizeof(RESERVATION);
+    header.passengers.offset = header.flight_seats.offset + header.flight_seats.count * sizeof(FLIGHT_SEATS);
+    // the header is written again at the end, when the passengers and strings sections are known
+    write_snapshot_bytes(&writer, &header, sizeof(SNAPSHOT_HEADER));
+
+    GHashTableIter iter;
+    gpointer key, value;
+    // the users are saved first, so the user ids of the reservations and passengers are shared with them
+    g_hash_table_iter_init(&iter, c->users);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        USER user = *(USER *) value;
+        encode_snapshot_strings(&writer, &user, user_fields, FIELDS_COUNT(user_fields));
+        write_snapshot_bytes(&writer, &user, sizeof(USER));
+    }
+    g_hash_table_iter_init(&iter, c->flights);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT flight = *(FLIGHT *) value;
+        encode_snapshot_strings(&writer, &flight, flight_fields, FIELDS_COUNT(flight_fields));
+        write_snapshot_bytes(&writer, &flight, sizeof(FLIGHT));
+    }
+    g_hash_table_iter_init(&iter, c->reservations);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        RESERVATION reservation = *(RESERVATION *) value;
+        reservation.user_id = user_id_of(c->users, reservation.user_id);
+        encode_snapshot_strings(&writer, &reservation, reservation_fields, FIELDS_COUNT(reservation_fields));
+        write_snapshot_bytes(&writer, &reservation, sizeof(RESERVATION));
+    }
+    // the passengers arrays are saved one after the other (each flight keeps the index of its first passenger)
+    guint64 passengers_count = 0;
+    g_hash_table_iter_init(&iter, c->passengers);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT_SEATS flight_seats = *(FLIGHT_SEATS *) value;
+        FLIGHT *flight = g_hash_table_lookup(c->flights, flight_seats.flight_id);
+        if (flight != NULL) {
+            flight_seats.flight_id = flight->id;
+        }
+        flight_seats.passengers = (char **) (uintptr_t) passengers_count;
+        passengers_count += flight_seats.total_passengers;
+        encode_snapshot_strings(&writer, &flight_seats, flight_seats_fields, FIELDS_COUNT(flight_seats_fields));
+        write_snapshot_bytes(&writer, &flight_seats, sizeof(FLIGHT_SEATS));
+    }
+    // (the hash table is not changed, so it is iterated in the same order)
+    g_hash_table_iter_init(&iter, c->passengers);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT_SEATS *flight_seats = (FLIGHT_SEATS *) value;
+        for (int i = 0; i < flight_seats->total_passengers; i++) {
+            char *passenger = (char *) (uintptr_t) add_snapshot_string(&writer, user_id_of(c->users, flight_seats->passengers[i]), STRING_SHARED);
+            write_snapshot_bytes(&writer, &passenger, sizeof(char*));
+        }
+    }
+    header.passengers.count = passengers_count;
+    header.strings.offset = header.passengers.offset + passengers_count * sizeof(char*);
+    header.strings.count = writer.strings->len;
+    write_snapshot_bytes(&writer, writer.strings->str, writer.strings->len);
+
+    if (fseek(writer.file, 0, SEEK_SET) != 0) {
+        perror("Error writing snapshot");
+        exit(EXIT_FAILURE);
+    }
+    write_snapshot_bytes(&writer, &header, sizeof(SNAPSHOT_HEADER));
+    if (fclose(writer.file) != 0) {
+        perror("Error writing snapshot");
+        exit(EXIT_FAILURE);
+    }
+    g_string_free(writer.strings, TRUE);
+    g_hash_table_destroy(writer.shared);
+}
+
+/**
+ * @brief Checks if a section of a snapshot is inside the file.
+ *
+ * @param section The section.
+ * @param element_size The size of each element of the section.
+ * @param file_size The size of the file.
+ * @return int 1 if the section is inside the file, 0 otherwise.
+ */
+static int valid_snapshot_section(SNAPSHOT_SECTION section, size_t element_size, size_t file_size) {
+    return section.offset <= file_size && section.count <= (file_size - section.offset) / element_size;
+}
+
+/**
+ * @brief Replaces the string offsets of a record (in the mapped snapshot) by pointers to the strings, and interns the interned ones.
+ *
+ * @param record The record.
+ * @param fields The string fields of the record.
+ * @param fields_count The number of string fields.
+ * @param strings The strings section.
+ * @param strings_size The size of the strings section.
+ * @param pool The catalog string pool.
+ * @return int 1 if every offset is inside the strings section, 0 otherwise.
+ */
+static int decode_snapshot_strings(void *record, const SNAPSHOT_STRING_FIELD *fields, int fields_count, char *strings, guint64 strings_size, STRING_POOL *pool) {
+    for (int i = 0; i < fields_count; i++) {
+        char **field = (char **) ((char *) record + fields[i].offset);
+        guint64 offset = (uintptr_t) *field;
+        if (offset >= strings_size) {
+            return 0;
+        }
+        *field = offset != 0 ? strings + offset : NULL;
+        if (fields[i].kind == STRING_INTERNED && *field != NULL) {
+            *field = intern_string(pool, *field);
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Checks a packed date of a record of a snapshot (the dates are used as indexes, e.g. in the metrics cube, @see build_metrics_cube).
+ *
+ * @param date The packed date. @see DATETIME
+ * @return int 1 if the date is in the ranges accepted by the parser (year 1 to 9999, month 1 to 12, day 1 to 31 and a valid time), 0 otherwise.
+ */
+static int valid_snapshot_date(DATETIME date) {
+    int year = DATETIME_YEAR(date), month = DATETIME_MONTH(date), day = DATETIME_DAY(date);
+    return year > 0 && year <= 9999 && month >= 1 && month <= 12 && day >= 1 && day <= 31
+        && DATETIME_HOUR(date) <= 23 && DATETIME_MINUTE(date) <= 59 && DATETIME_SECOND(date) <= 59;
+}
+
+/**
+ * @brief Replaces the offsets of the records of a mapped snapshot by pointers and adds the records to the catalog hash tables.
+ *
+ * @param c The catalog (its hash tables are already created).
+ * @param file The mapped snapshot (with a valid header). @see load_snapshot
+ * @return int 1 if every offset and date is valid, 0 if the snapshot is corrupted.
+ */
+static int decode_snapshot(CATALOG *c, MAPPED_FILE *file) {
+    SNAPSHOT_HEADER *header = (SNAPSHOT_HEADER *) file->data;
+    char *strings = file->data + header->strings.offset;
+    guint64 strings_size = header->strings.count;
+
+    USER *users = (USER *) (file->data + header->users.offset);
+    for (guint64 i = 0; i < header->users.count; i++) {
+        if (!decode_snapshot_strings(&users[i], user_fields, FIELDS_COUNT(user_fields), strings, strings_size, c->strings) || users[i].id == NULL
+        || !valid_snapshot_date(users[i].birth_date) || !valid_snapshot_date(users[i].account_creation)) {
+            return 0;
+        }
+        g_hash_table_insert(c->users, users[i].id, &users[i]);
+    }
+    FLIGHT *flights = (FLIGHT *) (file->data + header->flights.offset);
+    for (guint64 i = 0; i < header->flights.count; i++) {
+        if (!decode_snapshot_strings(&flights[i], flight_fields, FIELDS_COUNT(flight_fields), strings, strings_size, c->strings) || flights[i].id == NULL
+        || !valid_snapshot_date(flights[i].schedule_departure_date) || !valid_snapshot_date(flights[i].schedule_arrival_date)
+        || !valid_snapshot_date(flights[i].real_departure_date) || !valid_snapshot_date(flights[i].real_arrival_date)) {
+            return 0;
+        }
+        g_hash_table_insert(c->flights, flights[i].id, &flights[i]);
+    }
+    RESERVATION *reservations = (RESERVATION *) (file->data + header->reservations.offset);
+    for (guint64 i = 0; i < header->reservations.count; i++) {
+        if (!decode_snapshot_strings(&reservations[i], reservation_fields, FIELDS_COUNT(reservation_fields), strings, strings_size, c->strings) || reservations[i].id == NULL
+        || !valid_snapshot_date(reservations[i].begin_date) || !valid_snapshot_date(reservations[i].end_date)) {
+            return 0;
+        }
+        g_hash_table_insert(c->reservations, reservations[i].id, &reservations[i]);
+    }
+    char **passengers = (char **) (file->data + header->passengers.offset);
+    for (guint64 i = 0; i < header->passengers.count; i++) {
+        guint64 offset = (uintptr_t) passengers[i];
+        if (offset == 0 || offset >= strings_size) {
+            return 0;
+        }
+        passengers[i] = strings + offset;
+    }
+    FLIGHT_SEATS *flight_seats = (FLIGHT_SEATS *) (file->data + header->flight_seats.offset);
+    for (guint64 i = 0; i < header->flight_seats.count; i++) {
+        guint64 first = (uintptr_t) flight_seats[i].passengers;
+        if (!decode_snapshot_strings(&flight_seats[i], flight_seats_fields, FIELDS_COUNT(flight_seats_fields), strings, strings_size, c->strings) || flight_seats[i].flight_id == NULL
+        || flight_seats[i].total_passengers < 0 || first > header->passengers.count || (guint64) flight_seats[i].total_passengers > header->passengers.count - first) {
+            return 0;
+        }
+        flight_seats[i].passengers = passengers + first;
+        g_hash_table_insert(c->passengers, flight_seats[i].flight_id, &flight_seats[i]);
+    }
+    return 1;
+}
+
+/**
+ * @brief Loads a catalog from a snapshot file (the errors files are not written, they were written when the snapshot was saved).
+ *      The records stay in the mapped snapshot (only the pages with records are copied, to replace the offsets by pointers).
+ *
+ * @param c The catalog where the hash tables (and the mapped snapshot) are saved. @see newCatalog
+ * @param path The path of the snapshot file. @see save_snapshot
+ * @return int 1 if the snapshot was loaded, 0 if the file is not a valid snapshot (of this build), the catalog is not changed.
+ */
+int load_snapshot(CATALOG *c, const char *path) {
+    MAPPED_FILE *file = open_mapped_file(path);
+    SNAPSHOT_HEADER *header = (SNAPSHOT_HEADER *) file->data;
+    if (file->size < sizeof(SNAPSHOT_HEADER)
+    || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0
+    || header->version != SNAPSHOT_VERSION
+    || header->header_size != sizeof(SNAPSHOT_HEADER)
+    || header->record_sizes[0] != sizeof(USER) || header->record_sizes[1] != sizeof(FLIGHT)
+    || header->record_sizes[2] != sizeof(RESERVATION) || header->record_sizes[3] != sizeof(FLIGHT_SEATS)) {
+        fprintf(stderr, "Error loading snapshot: %s is not a snapshot of this version of the program\n", path);
+        close_mapped_dataset(file);
+        return 0;
+    }
+
+    // the interned strings are added to a new pool, so the catalog pool is only replaced if the snapshot is valid
+    CATALOG loaded;
+    loaded.users = g_hash_table_new(g_str_hash, g_str_equal);
+    loaded.flights = g_hash_table_new(g_str_hash, g_str_equal);
+    loaded.reservations = g_hash_table_new(g_str_hash, g_str_equal);
+    loaded.passengers = g_hash_table_new(g_str_hash, g_str_equal);
+    loaded.strings = new_string_pool();
+    if (!valid_snapshot_section(header->users, sizeof(USER), file->size)
+    || !valid_snapshot_section(header->flights, sizeof(FLIGHT), file->size)
+    || !valid_snapshot_section(header->reservations, sizeof(RESERVATION), file->size)
+    || !valid_snapshot_section(header->flight_seats, sizeof(FLIGHT_SEATS), file->size)
+    || !valid_snapshot_section(header->passengers, sizeof(char*), file->size)
+    || !valid_snapshot_section(header->strings, 1, file->size)
+    || !decode_snapshot(&loaded, file)) {
+        fprintf(stderr, "Error loading snapshot: %s is corrupted\n", path);
+        g_hash_table_destroy(loaded.users);
+        g_hash_table_destroy(loaded.flights);
+        g_hash_table_destroy(loaded.reservations);
+        g_hash_table_destroy(loaded.passengers);
+        free_string_pool(loaded.strings);
+        close_mapped_dataset(file);
+        return 0;
+    }
+
+    c->users = loaded.users;
+    c->flights = loaded.flights;
+    c->reservations = loaded.reservations;
+    c->passengers = loaded.passengers;
+    free_string_pool(c->strings);
+    c->strings = loaded.strings;
+    // the indexes are not saved, they are built again from the records
+    ARENA *arena = new_arena();
+    c->user_reservations = index_user_reservations(c->reservations, arena);
+    c->hotel_reservations = index_hotel_reservations(c->reservations, arena);
+    c->user_flights = index_user_flights(c->passengers, c->flights, arena);
+    c->origin_flights = index_origin_flights(c->flights, arena);
+    c->user_names = index_user_names(c->users, arena);
+    c->airport_passengers = index_airport_passengers(c->flights, c->passengers, arena);
+    c->metrics = build_metrics_cube(c, arena);
+    add_catalog_arena(c, arena);
+    // the records point into the mapped snapshot, so it is unmapped with the catalog
+    add_catalog_source(c, file);
+    return 1;
+}
+
+/**
+ * @brief Checks if a path given as a dataset is a snapshot (a dataset is a directory, a snapshot is a file).
+ *
+ * @param path The path.
+ * @return int 1 if the path is a (regular) file, 0 otherwise.
+ */
+int is_snapshot_path(const char *path) {
+    return g_file_test(path, G_FILE_TEST_IS_REGULAR);
+}
@@ -6,226 +6,150 @@
 #include "statistics.h"
 #include "catalog.h"
 #include "utils.h"
+#include "validation.h"
 #include "structs.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
 
 /**
- * @brief Calculates the number of nights between two dates.
- *      The dates must be in the format YYYY/MM/DD.
- * @param begin_date The begin date.
- * @param end_date The end date.
- * @return int
+ * @brief Gets the number of a day in the calendar used to count the nights of the reservations.
+ *      The nights between two dates are the difference of their numbers. @see calculate_nights
+ * @param date The date (packed, the time is ignored). @see DATETIME
+ * @return int The day number.
  */
-int calculate_nights(const char* begin_date, const char* end_date) {
-    int number_of_nights = 0;
-
-    int begin_year, begin_month, begin_day;
-    sscanf(begin_date, "%4d/%2d/%2d", &begin_year, &begin_month, &begin_day);
-    int end_year, end_month, end_day;
-    sscanf(end_date, "%4d/%2d/%2d", &end_year, &end_month, &end_day);
-
+int calculate_day_number(DATETIME date) {
     // Assuming each month has 30 days for simplicity
-    int begin_days = begin_year * 365 + begin_month * 30 + begin_day;
-    int end_days = end_year * 365 + end_month * 30 + end_day;
-
-    // Calculate the difference in days
-    number_of_nights = end_days - begin_days;
-
-    return number_of_nights;
+    return DATETIME_YEAR(date) * 365 + DATETIME_MONTH(date) * 30 + DATETIME_DAY(date);
 }
 
-// Função auxiliar para extrair o ano da data de nascimento
 /**
- * @brief Extracts the birth year from a date.
- * 
- * @param birth_date The birth date.
- * @return int 
+ * @brief Calculates the number of nights between two dates.
+ *      The dates are packed dates (the time is ignored). @see DATETIME
+ * @param begin_date The begin date.
+ * @param end_date The end date.
+ * @return int
  */
-static int extract_birth_year(const char *birth_date) {
-    int year;
-    // usa-se sscanf porque birth_date etá definido como char
-    sscanf(birth_date, "%4d", &year);
-    return year;
+int calculate_nights(DATETIME begin_date, DATETIME end_date) {
+    // Calculate the difference in days
+    return calculate_day_number(end_date) - calculate_day_number(begin_date);
 }
 
 /**
  * @brief Calculates the age of a person.
  * 
- * @param birth_date The birth date.
+ * @param birth_date The birth date (packed). @see DATETIME
  * @return int 
  */
-int calculate_age(const char *birth_date) {
+int calculate_age(DATETIME birth_date) {
     const int current_year = 2023; // se could use time.h to get the current year but since we are testing a fixed dataset, we can use a fixed value
 
-    // Extrair o ano de nascimento do formato da data
-    int birth_year = extract_birth_year(birth_date);
-
     // Calcular a idade
-    int age = current_year - birth_year;
+    int age = current_year - DATETIME_YEAR(birth_date);
 
     return age;
 }
 
-// count_number_flights we go to passengers hash table and count the number of passengers with the same user_id
-/*
-remembering that the passengers hash table has the following structure:
-    typedef struct {
-    char* flight_id;
-    char** passengers; // an array of user ids
-    int total_passengers;
-} FLIGHT_SEATS;
-
-key: flight_id
-value: FLIGHT_SEATS
-
-and we want to count the number of passengers with the same user_id, so we need to iterate over the passengers array and count the number of times the user_id appears
-*/
+// count_number_flights we get the flights of the user from the catalog index (instead of going through all the passengers)
 /**
  * @brief Counts the number of flights a user has (given a user_id).
  * 
- * @param passengers The passengers hash table.
+ * @param c The catalog. @see get_catalog_user_flights
  * @param user_id The user id.
  * @return int
 */
-int count_number_flights(GHashTable *passengers, const char *user_id) {
-    int count = 0;
-    GHashTableIter iter;
-    gpointer key, value;
-    g_hash_table_iter_init(&iter, passengers);
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        FLIGHT_SEATS *flight_seats = (FLIGHT_SEATS *) value;
-        for (int i = 0; i < flight_seats->total_passengers; i++) {
-            if (strcmp(flight_seats->passengers[i], user_id) == 0) {
-                count++;
-            }
-        }
-    }
+int count_number_flights(CATALOG *c, const char *user_id) {
+    int count;
+    get_catalog_user_flights(c, user_id, &count);
     return count;
 }
 
-// get_user_flights we go to passengers hash table and get all the flights that have the same user_id
+// get_user_flights we get the ids of the flights of the user from the catalog index
 /**
  * @brief Get the user flights object (given a user_id).
  * 
- * @param passengers The passengers hash table.
+ * @param c The catalog. @see get_catalog_user_flights
  * @param user_id The user id.
  * @return char** 
  */
-char** get_user_flights(GHashTable *passengers, const char *user_id) {
-    char** flights = NULL;
-    int flights_count = 0;
-
-    GHashTableIter iter;
-    gpointer key, value;
-    g_hash_table_iter_init(&iter, passengers);
-
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        FLIGHT_SEATS *flight_seats = (FLIGHT_SEATS *) value;
-
-        for (int i = 0; i < flight_seats->total_passengers; i++) {
-            if (strcmp(flight_seats->passengers[i], user_id) == 0) {
-                flights = g_realloc(flights, sizeof(char*) * (flights_count + 1));
-                flights[flights_count] = g_strdup(flight_seats->flight_id);
-                flights_count++;
-            }
-        }
+char** get_user_flights(CATALOG *c, const char *user_id) {
+    int flights_count;
+    FLIGHT **user_flights = get_catalog_user_flights(c, user_id, &flights_count);
+    char** flights = g_malloc(sizeof(char*) * (flights_count + 1));
+    for (int i = 0; i < flights_count; i++) {
+        flights[i] = g_strdup(user_flights[i]->id);
     }
 
     // Null-terminate the array
-    flights = g_realloc(flights, sizeof(char*) * (flights_count + 1));
     flights[flights_count] = NULL;
 
     return flights;
 }
 
-// count_number_reservations we go to reservations hash table and count the number of reservations with the same user_id
+// count_number_reservations we get the reservations of the user from the catalog index (instead of going through all the reservations)
 /**
  * @brief Counts the number of reservations a user has (given a user_id).
  * 
- * @param reservations The reservations hash table.
+ * @param c The catalog. @see get_catalog_user_reservations
  * @param user_id The user id.
  * @return int 
  */
-int count_number_reservations(GHashTable *reservations, const char *user_id) {
-    int count = 0;
-    GHashTableIter iter;
-    gpointer key, value;
-    g_hash_table_iter_init(&iter, reservations);
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        RESERVATION *reservation = (RESERVATION *) value;
-        if (strcmp(reservation->user_id, user_id) == 0) {
-            count++;
-        }
-    }
-    return count;
+int count_number_reservations(CATALOG *c, const char *user_id) {
+    USER_RESERVATIONS *user_reservations = get_catalog_user_reservations(c, user_id);
+    return user_reservations != NULL ? user_reservations->total_reservations : 0;
 }
 
-// get_user_reservations we go to reservations hash table and get all the reservations that have the same user_id
+// get_user_reservations we get the ids of the reservations of the user from the catalog index
 /**
  * @brief Get the user reservations object (given a user_id).
  * 
- * @param reservations The reservations hash table.
+ * @param c The catalog. @see get_catalog_user_reservations
  * @param user_id The user id.
  * @return char** 
  */
-char** get_user_reservations(GHashTable *reservations, const char *user_id) {
-    char** reservations_array = NULL;
-    int reservations_count = 0;
-
-    GHashTableIter iter;
-    gpointer key, value;
-    g_hash_table_iter_init(&iter, reservations);
-
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        RESERVATION *reservation = (RESERVATION *) value;
-        if (strcmp(reservation->user_id, user_id) == 0) {
-            reservations_array = g_realloc(reservations_array, sizeof(char*) * (reservations_count + 1));
-            reservations_array[reservations_count] = g_strdup(reservation->id);
-            reservations_count++;
-        }
+char** get_user_reservations(CATALOG *c, const char *user_id) {
+    USER_RESERVATIONS *user_reservations = get_catalog_user_reservations(c, user_id);
+    int reservations_count = user_reservations != NULL ? user_reservations->total_reservations : 0;
+    char** reservations_array = g_malloc(sizeof(char*) * (reservations_count + 1));
+    for (int i = 0; i < reservations_count; i++) {
+        reservations_array[i] = g_strdup(user_reservations->reservations[i]->id);
     }
 
     // Null-terminate the array
-    reservations_array = g_realloc(reservations_array, sizeof(char*) * (reservations_count + 1));
     reservations_array[reservations_count] = NULL;
 
     return reservations_array;
 }
 
-// calculate_total_spent we go to reservations hash table and sum the total price of the reservations with the same user_id
+// calculate_total_spent we sum the total price of the reservations of the user (from the catalog index)
 // reservation_price = price_per_night * number_of_nights + (price_per_night * number_of_nights) / 100 * city_tax
 // total_spent (for a user) = sum(reservation_price)
 /**
  * @brief Calculates the total amount of money a user has spent (given a user_id).
  * 
- * @param reservations The reservations hash table.
+ * @param c The catalog. @see get_catalog_user_reservations
  * @param user_id The user id.
  * @return double 
  */
-double calculate_total_spent(GHashTable *reservations, const char *user_id) {
-    // first we go to a line that has the same user_id
+double calculate_total_spent(CATALOG *c, const char *user_id) {
+    // we go through the reservations of the user
     // next we check how many nights the user stayed in the hotel (end_date - begin_date)
     // next we check the price_per_night and multiply by the number of nights
     double total_spent = 0;
-    GHashTableIter iter;
-    gpointer key, value;
-    g_hash_table_iter_init(&iter, reservations);
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        RESERVATION *reservation = (RESERVATION *) value;
-        if (strcmp(reservation->user_id, user_id) == 0) {
-            // calculate the number of nights
-            int number_of_nights = calculate_nights(reservation->begin_date, reservation->end_date);
-            // calculate the total spent
-            double price_per_night = atof(reservation->price_per_night);
-            double city_tax = atof(reservation->city_tax);
-            /*printf("number_of_nights: %d\n", number_of_nights);
-            printf("price_per_night: %f\n", price_per_night);
-            printf("city_tax: %s\n", reservation->city_tax);*/
-            total_spent += price_per_night * number_of_nights + (price_per_night * number_of_nights) / 100 * city_tax;
-        }
+    USER_RESERVATIONS *user_reservations = get_catalog_user_reservations(c, user_id);
+    if (user_reservations == NULL) {
+        return total_spent;
+    }
+    for (int i = 0; i < user_reservations->total_reservations; i++) {
+        RESERVATION *reservation = user_reservations->reservations[i];
+        // calculate the number of nights
+        int number_of_nights = calculate_nights(reservation->begin_date, reservation->end_date);
+        // calculate the total spent
+        double price_per_night = reservation->price_per_night;
+        double city_tax = reservation->city_tax;
+        total_spent += price_per_night * number_of_nights + (price_per_night * number_of_nights) / 100 * city_tax;
     }
     return total_spent;
 }
@@ -239,31 +163,26 @@ double calculate_total_spent(GHashTable *reservations, const char *user_id) {
  * @param city_tax The city tax.
  * @return double 
  */
-double calculate_total_price(const char *price_per_night, int number_of_nights, int city_tax) {
+double calculate_total_price(int price_per_night, int number_of_nights, int city_tax) {
     double total_price = 0;
-    double price_per_night_double = atof(price_per_night);
+    double price_per_night_double = price_per_night;
     total_price = price_per_night_double * number_of_nights + (price_per_night_double * number_of_nights) / 100 * city_tax;
     return total_price;
 }
 
 // calculate the delay between the schedule_departure_date and the real_departure_date of a flight
-// remember that the real_departure_date is in the format: YYYY/MM/DD HH:MM:SS
 /**
  * @brief Calculates the delay between the schedule_departure_date and the real_departure_date of a flight.
- *    The dates must be in the format YYYY/MM/DD HH:MM:SS.
+ *    The dates are packed dates with time. @see DATETIME
  * @param schedule_departure_date The schedule departure date.
  * @param real_departure_date The real departure date.
  * @return int 
  */
-int calculate_delay(const char *schedule_departure_date, const char *real_departure_date) {
+int calculate_delay(DATETIME schedule_departure_date, DATETIME real_departure_date) {
     int delay = 0;
-    // first we need to extract the year, month, day, hour, minute and second from the real_departure_date
-    int real_year, real_month, real_day, real_hour, real_minute, real_second;
-    sscanf(real_departure_date, "%4d/%2d/%2d %2d:%2d:%2d", &real_year, &real_month, &real_day, &real_hour, &real_minute, &real_second);
-
-    // next we need to extract the year, month, day, hour, minute and second from the schedule_departure_date
-    int schedule_year, schedule_month, schedule_day, schedule_hour, schedule_minute, schedule_second;
-    sscanf(schedule_departure_date, "%4d/%2d/%2d %2d:%2d:%2d", &schedule_year, &schedule_month, &schedule_day, &schedule_hour, &schedule_minute, &schedule_second);
+    // first we need to extract the hour, minute and second from the real_departure_date and the schedule_departure_date
+    int real_hour = DATETIME_HOUR(real_departure_date), real_minute = DATETIME_MINUTE(real_departure_date), real_second = DATETIME_SECOND(real_departure_date);
+    int schedule_hour = DATETIME_HOUR(schedule_departure_date), schedule_minute = DATETIME_MINUTE(schedule_departure_date), schedule_second = DATETIME_SECOND(schedule_departure_date);
 
     // if the real_hour is greater than the schedule_hour, we have a delay
     if (real_hour > schedule_hour) {
@@ -283,64 +202,159 @@ int calculate_delay(const char *schedule_departure_date, const char *real_depart
     return (delay*60); // we return the delay in seconds
 }
 
-// date_comparator_wt (without time) is a comparator function used to qsort, it compares two dates and returns: -1 if date1 < date2, 0 if date1 == date2, 1 if date1 > date2
+// get_flight_delay is the delay of query 7 (the difference between the dates, in seconds, without the seconds of the dates)
 /**
- * @brief Compares two dates and returns: -1 if date1 < date2, 0 if date1 == date2, 1 if date1 > date2.
+ * @brief Gets the flight delay (in seconds), from the schedule and the real departure dates.
  * 
- * @param date1 The first date.
- * @param date2 The second date.
- * @return int 
+ * @param flight The flight.
+ * @return int The flight delay.
  */
-int date_comparator_wt(const char *date1, const char *date2) {
-    // first we need to extract the year, month and day from the date1
-    int year1, month1, day1;
-    sscanf(date1, "%4d/%2d/%2d", &year1, &month1, &day1);
+int get_flight_delay(FLIGHT *flight) {
+    // get the year, month, day, hour and minute from the estimated_departure_date and departure_date (packed when the flight was parsed)
+    DATETIME estimated_departure_date = flight->schedule_departure_date;
+    DATETIME departure_date = flight->real_departure_date;
+    int estimated_departure_date_year = DATETIME_YEAR(estimated_departure_date);
+    int estimated_departure_date_month = DATETIME_MONTH(estimated_departure_date);
+    int estimated_departure_date_day = DATETIME_DAY(estimated_departure_date);
+    int estimated_departure_date_hour = DATETIME_HOUR(estimated_departure_date);
+    int estimated_departure_date_minute = DATETIME_MINUTE(estimated_departure_date);
+    int departure_date_year = DATETIME_YEAR(departure_date);
+    int departure_date_month = DATETIME_MONTH(departure_date);
+    int departure_date_day = DATETIME_DAY(departure_date);
+    int departure_date_hour = DATETIME_HOUR(departure_date);
+    int departure_date_minute = DATETIME_MINUTE(departure_date);
+
+    // calculate the delay
+    int delay = 0;
+    delay += (departure_date_year - estimated_departure_date_year) * 365 * 24 * 60 * 60;
+    delay += (departure_date_month - estimated_departure_date_month) * 30 * 24 * 60 * 60;
+    delay += (departure_date_day - estimated_departure_date_day) * 24 * 60 * 60;
+    delay += (departure_date_hour - estimated_departure_date_hour) * 60 * 60;
+    delay += (departure_date_minute - estimated_departure_date_minute) * 60;
 
-    // next we need to extract the year, month and day from the date2
-    int year2, month2, day2;
-    sscanf(date2, "%4d/%2d/%2d", &year2, &month2, &day2);
+    return delay;
+}
 
-    // if year1 < year2, we return -1
-    if (year1 < year2) {
-        return -1;
-    }
+/**
+ * @brief Compares two delays (for qsort).
+ * 
+ * @param a A pointer to the first delay.
+ * @param b A pointer to the second delay.
+ * @return int The comparator (< 0 if a < b).
+ */
+static int compare_delays(const void *a, const void *b) {
+    int delay_a = *(const int *) a;
+    int delay_b = *(const int *) b;
+    return (delay_a > delay_b) - (delay_a < delay_b);
+}
 
-    // if year1 > year2, we return 1
-    if (year1 > year2) {
-        return 1;
+/**
+ * @brief Selects the k-th smallest value of an array (introselect: a quickselect with a median of three pivot that sorts
+ *      the part left when it goes deeper than 2 log2(count), so it is linear on average and never worse than a sort).
+ *      The values are reordered: values[k] is the k-th smallest, the ones before it are not greater and the ones after it are not smaller.
+ * 
+ * @param values The values.
+ * @param count The number of values (at least one).
+ * @param k The position of the value in the sorted order (from 0 to count - 1).
+ * @return int The k-th smallest value.
+ */
+static int select_nth(int *values, int count, int k) {
+    int low = 0, high = count - 1;
+    int depth = 0;
+    for (int n = count; n > 1; n >>= 1) {
+        depth += 2;
     }
-
-    // if year1 == year2, we need to check the month
-    if (year1 == year2) {
-        // if month1 < month2, we return -1
-        if (month1 < month2) {
-            return -1;
+    while (high - low > 16) {
+        if (depth-- == 0) {
+            qsort(values + low, high - low + 1, sizeof(int), compare_delays);
+            return values[k];
         }
-
-        // if month1 > month2, we return 1
-        if (month1 > month2) {
-            return 1;
+        // the median of the first, the middle and the last value is the pivot (and they are left in order, as sentinels)
+        int middle = low + (high - low) / 2;
+        if (values[middle] < values[low]) { int tmp = values[middle]; values[middle] = values[low]; values[low] = tmp; }
+        if (values[high] < values[low]) { int tmp = values[high]; values[high] = values[low]; values[low] = tmp; }
+        if (values[high] < values[middle]) { int tmp = values[high]; values[high] = values[middle]; values[middle] = tmp; }
+        int pivot = values[middle];
+        // Hoare partition: values[low..j] <= pivot <= values[j + 1..high]
+        int i = low, j = high;
+        while (1) {
+            while (values[++i] < pivot);
+            while (values[--j] > pivot);
+            if (i >= j) break;
+            int tmp = values[i]; values[i] = values[j]; values[j] = tmp;
         }
+        if (k <= j) {
+            high = j;
+        } else {
+            low = j + 1;
+        }
+    }
+    // a small part is sorted by insertion
+    for (int i = low + 1; i <= high; i++) {
+        int value = values[i];
+        int j = i - 1;
+        while (j >= low && values[j] > value) {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = value;
+    }
+    return values[k];
+}
 
-        // if month1 == month2, we need to check the day
-        if (month1 == month2) {
-            // if day1 < day2, we return -1
-            if (day1 < day2) {
-                return -1;
-            }
-
-            // if day1 > day2, we return 1
-            if (day1 > day2) {
-                return 1;
-            }
-
-            // if day1 == day2, we return 0
-            if (day1 == day2) {
-                return 0;
-            }
+// median_delay selects the delay in the middle (and, if the number of delays is even, the greatest delay before it) without sorting them
+/**
+ * @brief Calculates the median of the delays of the flights of an airport.
+ * 
+ * @param delays The delays (they are reordered). @see select_nth
+ * @param delays_count The number of delays (at least one).
+ * @return int The median (the average of the two delays in the middle, truncated, if the number of delays is even).
+ */
+int median_delay(int *delays, int delays_count) {
+    int middle = select_nth(delays, delays_count, delays_count / 2);
+    if (delays_count % 2 == 0) {
+        // the other delay in the middle is the greatest of the ones before it
+        int before = delays[0];
+        for (int i = 1; i < delays_count / 2; i++) {
+            before = MAX(before, delays[i]);
         }
+        return (before + middle) / 2;
     }
-    return 0;
+    return middle;
+}
+
+/**
+ * @brief Calculates a percentile of the delays of the flights of an airport (nearest rank: the smallest delay
+ *      that is not smaller than percentile% of the delays, e.g. 90 for the p90 and 99 for the p99).
+ * 
+ * @param delays The delays (they are reordered). @see select_nth
+ * @param delays_count The number of delays (at least one).
+ * @param percentile The percentile (from 1 to 100).
+ * @return int The delay of the percentile.
+ */
+int percentile_delay(int *delays, int delays_count, int percentile) {
+    // rank = ceil(percentile / 100 * delays_count), from 1 to delays_count
+    int rank = (int) (((long long) percentile * delays_count + 99) / 100);
+    rank = CLAMP(rank, 1, delays_count);
+    return select_nth(delays, delays_count, rank - 1);
+}
+
+// date_comparator_wt (without time) is a comparator function used to qsort, it compares two dates and returns: -1 if date1 < date2, 0 if date1 == date2, 1 if date1 > date2
+/**
+ * @brief Compares two dates and returns: -1 if date1 < date2, 0 if date1 == date2, 1 if date1 > date2.
+ * 
+ * @param date1 The first date.
+ * @param date2 The second date.
+ * @return int 
+ */
+int date_comparator_wt(const char *date1, const char *date2) {
+    // only the year, month and day are compared
+    DATETIME d1, d2;
+    scanDate(date1, &d1);
+    scanDate(date2, &d2);
+    d1 = DATETIME_DATE(d1);
+    d2 = DATETIME_DATE(d2);
+    return (d1 > d2) - (d1 < d2);
 }
 
 // date_comparator (with time) is a comparator function used to qsort, it compares two dates and returns: -1 if date1 < date2, 0 if date1 == date2, 1 if date1 > date2
@@ -352,92 +366,148 @@ int date_comparator_wt(const char *date1, const char *date2) {
  * @return int 
  */
 int date_comparator(const char *date1, const char *date2) {
-    // first we need to extract the year, month, day, hour, minute and second from the date1
-    int year1, month1, day1, hour1, minute1, second1;
-    sscanf(date1, "%4d/%2d/%2d %2d:%2d:%2d", &year1, &month1, &day1, &hour1, &minute1, &second1);
-
-    // next we need to extract the year, month, day, hour, minute and second from the date2
-    int year2, month2, day2, hour2, minute2, second2;
-    sscanf(date2, "%4d/%2d/%2d %2d:%2d:%2d", &year2, &month2, &day2, &hour2, &minute2, &second2);
+    // the packed dates keep the chronological order (year, month, day, hour, minute and second)
+    DATETIME d1, d2;
+    scanDate(date1, &d1);
+    scanDate(date2, &d2);
+    return (d1 > d2) - (d1 < d2);
+}
 
-    // if year1 < year2, we return -1
-    if (year1 < year2) {
-        return -1;
+/**
+ * @brief Adds a value to a metric of the day, the month and the year of a date (the year is added to the cube if it is not there).
+ * 
+ * @param cube The cube.
+ * @param date The date (packed). @see DATETIME
+ * @param metric The offset of the metric in METRICS (e.g. offsetof(METRICS, flights)).
+ * @param value The value.
+ * @param levels The periods the value is added to: 1 only the day, 2 the day and the month, 3 the day, the month and the year.
+ * @param arena The arena where the years are allocated.
+ */
+static void add_metric(METRICS_CUBE *cube, DATETIME date, size_t metric, int value, int levels, ARENA *arena) {
+    int year = DATETIME_YEAR(date);
+    YEAR_METRICS *year_metrics = g_hash_table_lookup(cube->years, GINT_TO_POINTER(year));
+    if (year_metrics == NULL) {
+        year_metrics = arena_alloc(arena, sizeof(YEAR_METRICS));
+        memset(year_metrics, 0, sizeof(YEAR_METRICS));
+        year_metrics->year = year;
+        g_hash_table_insert(cube->years, GINT_TO_POINTER(year), year_metrics);
     }
-
-    // if year1 > year2, we return 1
-    if (year1 > year2) {
-        return 1;
+    METRICS *periods[3] = {
+        &year_metrics->total,
+        &year_metrics->months[DATETIME_MONTH(date) - 1],
+        &year_metrics->days[DATETIME_MONTH(date) - 1][DATETIME_DAY(date) - 1]
+    };
+    for (int i = 3 - levels; i < 3; i++) {
+        *(int *) ((char *) periods[i] + metric) += value;
     }
+}
 
-    // if year1 == year2, we need to check the month
-    if (year1 == year2) {
-        // if month1 < month2, we return -1
-        if (month1 < month2) {
-            return -1;
-        }
+/**
+ * @brief Compares two dates (for qsort).
+ * 
+ * @param a A pointer to the first date (DATETIME*).
+ * @param b A pointer to the second date (DATETIME*).
+ * @return int The comparator (< 0 if a comes first).
+ */
+static int compare_dates(const void *a, const void *b) {
+    DATETIME date_a = *(const DATETIME *) a;
+    DATETIME date_b = *(const DATETIME *) b;
+    return (date_a > date_b) - (date_a < date_b);
+}
 
-        // if month1 > month2, we return 1
-        if (month1 > month2) {
-            return 1;
+/**
+ * @brief Counts each passenger once in the unique passengers of each day, month and year they have a flight in.
+ *      The users are the rows of the flights by user index, so the flights of a user are consecutive: they are
+ *      sorted by date and the user is counted in a period when its first flight in the period is found.
+ * 
+ * @param cube The cube.
+ * @param user_flights The flights of each user. @see struct USER_FLIGHTS
+ * @param arena The arena where the years are allocated.
+ */
+static void add_unique_passengers(METRICS_CUBE *cube, USER_FLIGHTS *user_flights, ARENA *arena) {
+    guint max_flights = 0;
+    for (guint row = 0; row < user_flights->users_count; row++) {
+        max_flights = MAX(max_flights, user_flights->offsets[row + 1] - user_flights->offsets[row]);
+    }
+    DATETIME *dates = g_new(DATETIME, MAX(max_flights, 1));
+    for (guint row = 0; row < user_flights->users_count; row++) {
+        guint count = user_flights->offsets[row + 1] - user_flights->offsets[row];
+        FLIGHT **flights = user_flights->flights + user_flights->offsets[row];
+        for (guint i = 0; i < count; i++) {
+            dates[i] = DATETIME_DATE(flights[i]->schedule_departure_date) << 17; // without the time
         }
-
-        // if month1 == month2, we need to check the day
-        if (month1 == month2) {
-            // if day1 < day2, we return -1
-            if (day1 < day2) {
-                return -1;
-            }
-
-            // if day1 > day2, we return 1
-            if (day1 > day2) {
-                return 1;
+        qsort(dates, count, sizeof(DATETIME), compare_dates);
+        for (guint i = 0; i < count; i++) {
+            if (i > 0 && dates[i] == dates[i - 1]) {
+                continue;
             }
-
-            // if day1 == day2, we need to check the hour
-            if (day1 == day2) {
-                // if hour1 < hour2, we return -1
-                if (hour1 < hour2) {
-                    return -1;
-                }
-
-                // if hour1 > hour2, we return 1
-                if (hour1 > hour2) {
-                    return 1;
-                }
-
-                // if hour1 == hour2, we need to check the minute
-                if (hour1 == hour2) {
-                    // if minute1 < minute2, we return -1
-                    if (minute1 < minute2) {
-                        return -1;
-                    }
-
-                    // if minute1 > minute2, we return 1
-                    if (minute1 > minute2) {
-                        return 1;
-                    }
-
-                    // if minute1 == minute2, we need to check the second
-                    if (minute1 == minute2) {
-                        // if second1 < second2, we return -1
-                        if (second1 < second2) {
-                            return -1;
-                        }
-
-                        // if second1 > second2, we return 1
-                        if (second1 > second2) {
-                            return 1;
-                        }
-
-                        // if second1 == second2, we return 0
-                        if (second1 == second2) {
-                            return 0;
-                        }
-                    }
-                }
+            int levels = 1; // a new day
+            if (i == 0 || DATETIME_YEAR(dates[i]) != DATETIME_YEAR(dates[i - 1])) {
+                levels = 3;
+            } else if (DATETIME_MONTH(dates[i]) != DATETIME_MONTH(dates[i - 1])) {
+                levels = 2;
             }
+            add_metric(cube, dates[i], offsetof(METRICS, unique_passengers), 1, levels, arena);
         }
     }
-    return 0;
-}
\ No newline at end of file
+    g_free(dates);
+}
+
+/**
+ * @brief Compares two years of the cube (for qsort).
+ * 
+ * @param a A pointer to the first year (YEAR_METRICS**).
+ * @param b A pointer to the second year (YEAR_METRICS**).
+ * @return int The comparator (< 0 if a comes first).
+ */
+static int compare_year_metrics(const void *a, const void *b) {
+    int year_a = (*(YEAR_METRICS **) a)->year;
+    int year_b = (*(YEAR_METRICS **) b)->year;
+    return (year_a > year_b) - (year_a < year_b);
+}
+
+// build_metrics_cube goes through the users, flights, passengers and reservations once and counts them in their year, month and day,
+// the unique passengers are counted from the flights of each user
+/**
+ * @brief Builds the metrics of query 10 for every year, month and day with records. @see struct METRICS_CUBE
+ * 
+ * @param c The catalog (with the dataset loaded).
+ * @param arena The arena where the cube and its years are allocated.
+ * @return METRICS_CUBE* The cube (only its years hash table must be destroyed).
+ */
+METRICS_CUBE *build_metrics_cube(CATALOG *c, ARENA *arena) {
+    METRICS_CUBE *cube = arena_alloc(arena, sizeof(METRICS_CUBE));
+    cube->years = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, c->users);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        add_metric(cube, ((USER *) value)->account_creation, offsetof(METRICS, users), 1, 3, arena);
+    }
+    g_hash_table_iter_init(&iter, c->flights);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        add_metric(cube, ((FLIGHT *) value)->schedule_departure_date, offsetof(METRICS, flights), 1, 3, arena);
+    }
+    g_hash_table_iter_init(&iter, c->passengers);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        FLIGHT_SEATS *flight_seats = (FLIGHT_SEATS *) value;
+        FLIGHT *flight = g_hash_table_lookup(c->flights, flight_seats->flight_id);
+        if (flight == NULL) continue;
+        add_metric(cube, flight->schedule_departure_date, offsetof(METRICS, passengers), flight_seats->total_passengers, 3, arena);
+    }
+    g_hash_table_iter_init(&iter, c->reservations);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        add_metric(cube, ((RESERVATION *) value)->begin_date, offsetof(METRICS, reservations), 1, 3, arena);
+    }
+    add_unique_passengers(cube, c->user_flights, arena);
+
+    cube->years_count = g_hash_table_size(cube->years);
+    cube->sorted_years = arena_alloc(arena, MAX(cube->years_count, 1) * sizeof(YEAR_METRICS*));
+    int i = 0;
+    g_hash_table_iter_init(&iter, cube->years);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        cube->sorted_years[i++] = (YEAR_METRICS *) value;
+    }
+    qsort(cube->sorted_years, cube->years_count, sizeof(YEAR_METRICS*), compare_year_metrics);
+    return cube;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file stringPool.c
+ * @brief Implementation of the string pool (interning of the low cardinality columns).
+ */
+#include "stringPool.h"
+
+/**
+ * @brief Creates a new (empty) string pool. A pool is not thread safe, each parser worker must use its own pool. @see merge_string_pools
+ *
+ * @return STRING_POOL* The new string pool. @see struct STRING_POOL
+ */
+STRING_POOL *new_string_pool(void) {
+    STRING_POOL *pool = g_new(STRING_POOL, 1);
+    pool->strings = g_hash_table_new(g_str_hash, g_str_equal);
+    return pool;
+}
+
+/**
+ * @brief Interns a value: returns the value already in the pool that is equal to it, or adds it to the pool.
+ *      The value is not copied, it must outlive the pool (e.g. a slice of a mapped file).
+ *
+ * @param pool The string pool. @see new_string_pool
+ * @param value The value to intern.
+ * @return char* The interned value (compare it with other interned values of the pool by pointer).
+ */
+char *intern_string(STRING_POOL *pool, char *value) {
+    char *interned = g_hash_table_lookup(pool->strings, value);
+    if (interned == NULL) {
+        g_hash_table_insert(pool->strings, value, value);
+        interned = value;
+    }
+    return interned;
+}
+
+/**
+ * @brief Finds the interned value equal to a string (e.g. a query argument), without adding it to the pool.
+ *
+ * @param pool The string pool. @see new_string_pool
+ * @param value The string to find.
+ * @return char* The interned value or NULL if no record has that value (so nothing can be equal to it).
+ */
+char *find_interned_string(STRING_POOL *pool, const char *value) {
+    return g_hash_table_lookup(pool->strings, value);
+}
+
+/**
+ * @brief Merges a string pool (e.g. the pool of a parser worker) into another pool and frees the source pool.
+ *      The values of the source that were already in the destination stop being interned, so they must be
+ *      replaced in the records by the destination ones (with the returned remap table). @see remap_interned_string
+ *
+ * @param destination The pool that receives the values.
+ * @param source The pool that is merged (it is freed).
+ * @return GHashTable* The remap table (source value -> destination value, by pointer) or NULL if no value had to be remapped.
+ */
+GHashTable *merge_string_pools(STRING_POOL *destination, STRING_POOL *source) {
+    GHashTable *remap = NULL;
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, source->strings);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        char *interned = intern_string(destination, value);
+        if (interned != value) {
+            if (remap == NULL) {
+                remap = g_hash_table_new(g_direct_hash, g_direct_equal);
+            }
+            g_hash_table_insert(remap, value, interned);
+        }
+    }
+    free_string_pool(source);
+    return remap;
+}
+
+/**
+ * @brief Gets the value that replaces an interned value after a merge. @see merge_string_pools
+ *
+ * @param remap The remap table (can be NULL, if nothing was remapped).
+ * @param value The interned value of the merged pool.
+ * @return char* The interned value of the destination pool.
+ */
+char *remap_interned_string(GHashTable *remap, char *value) {
+    if (remap == NULL) {
+        return value;
+    }
+    char *interned = g_hash_table_lookup(remap, value);
+    return interned != NULL ? interned : value;
+}
+
+/**
+ * @brief Gets the number of distinct values in a string pool.
+ *
+ * @param pool The string pool.
+ * @return guint The number of distinct values.
+ */
+guint string_pool_size(STRING_POOL *pool) {
+    return g_hash_table_size(pool->strings);
+}
+
+/**
+ * @brief Frees a string pool (the values are not freed, they belong to the records).
+ *
+ * @param pool The string pool.
+ */
+void free_string_pool(STRING_POOL *pool) {
+    if (pool != NULL) {
+        g_hash_table_destroy(pool->strings);
+        g_free(pool);
+    }
+}
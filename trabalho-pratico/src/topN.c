@@ -0,0 +1,105 @@
+/**
+ * @file topN.c
+ * @brief Implementation of the top N selection (the best N of many items, without sorting all of them).
+ */
+#include "topN.h"
+
+/**
+ * @brief Creates an empty top N.
+ *
+ * @param n The number of items to keep (nothing is kept if it is not positive).
+ * @param before The order of the items (the best first). @see TOP_N_BEFORE
+ * @param data Passed to before.
+ * @return TOP_N* The top N. @see struct TOP_N
+ */
+TOP_N *new_top_n(int n, TOP_N_BEFORE before, gconstpointer data) {
+    TOP_N *top = g_new(TOP_N, 1);
+    top->n = MAX(n, 0);
+    top->size = 0;
+    top->capacity = 0;
+    top->heap = NULL;
+    top->before = before;
+    top->data = data;
+    return top;
+}
+
+/**
+ * @brief Restores the heap property from a position down (the worst item at the root).
+ *
+ * @param top The top N.
+ * @param size The size of the heap.
+ * @param position The position to sift down.
+ */
+static void sift_down(TOP_N *top, int size, int position) {
+    gpointer *heap = top->heap;
+    while (1) {
+        int worst = position;
+        int left = 2 * position + 1, right = 2 * position + 2;
+        if (left < size && top->before(heap[worst], heap[left], top->data)) worst = left;
+        if (right < size && top->before(heap[worst], heap[right], top->data)) worst = right;
+        if (worst == position) return;
+        gpointer tmp = heap[position];
+        heap[position] = heap[worst];
+        heap[worst] = tmp;
+        position = worst;
+    }
+}
+
+/**
+ * @brief Offers an item to the top N: it is kept if there are less than N items or if it is better than the worst of them.
+ *
+ * @param top The top N.
+ * @param item The item.
+ */
+void top_n_offer(TOP_N *top, gpointer item) {
+    if (top->size < top->n) {
+        if (top->size == top->capacity) {
+            top->capacity = MIN(top->n, MAX(64, 2 * top->capacity));
+            top->heap = g_renew(gpointer, top->heap, top->capacity);
+        }
+        // sift up
+        int position = top->size++;
+        top->heap[position] = item;
+        while (position > 0 && top->before(top->heap[(position - 1) / 2], top->heap[position], top->data)) {
+            int parent = (position - 1) / 2;
+            gpointer tmp = top->heap[parent];
+            top->heap[parent] = top->heap[position];
+            top->heap[position] = tmp;
+            position = parent;
+        }
+    } else if (top->n > 0 && top->before(item, top->heap[0], top->data)) {
+        top->heap[0] = item;
+        sift_down(top, top->size, 0);
+    }
+}
+
+/**
+ * @brief Sorts the items kept, from the best (the worst is moved to the end of the heap until it is empty).
+ *      No more items can be offered after the top is sorted.
+ *
+ * @param top The top N.
+ * @param size Where the number of items is saved (at most N).
+ * @return gpointer* The items, from the best (owned by the top N).
+ */
+gpointer *top_n_sorted(TOP_N *top, int *size) {
+    for (int remaining = top->size - 1; remaining > 0; remaining--) {
+        gpointer worst = top->heap[0];
+        top->heap[0] = top->heap[remaining];
+        sift_down(top, remaining, 0);
+        top->heap[remaining] = worst;
+    }
+    *size = top->size;
+    return top->heap;
+}
+
+/**
+ * @brief Frees a top N (the items are not freed).
+ *
+ * @param top The top N.
+ */
+void free_top_n(TOP_N *top) {
+    if (top != NULL) {
+        g_free(top->heap);
+        g_free(top);
+    }
+}
@@ -3,13 +3,21 @@
 * @brief Source file for the unit testing module.
 */
 #include "unitTesting.h"
+#include "lineReader.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <glib.h>
 
-void run_unit_tests(char *outputDir, char *expectedOutputDir) {
+/**
+ * @brief Compares each file of the expected output directory with the file with the same name in the output directory.
+ *
+ * @param outputDir The output directory.
+ * @param expectedOutputDir The expected output directory.
+ * @return int The number of files with differences (0 if all the tests passed).
+ */
+int run_unit_tests(char *outputDir, char *expectedOutputDir) {
     // first lets make a check on the path, if they dont end in / we add it
     if (outputDir[strlen(outputDir) - 1] != '/') {
         strcat(outputDir, "/");
@@ -25,6 +33,7 @@ void run_unit_tests(char *outputDir, char *expectedOutputDir) {
         exit(1);
     }
     struct dirent *entry;
+    int failed = 0;
     while ((entry = readdir(dir)) != NULL) {
         // we need to check if the file exists in outputDir
         char *expectedOutputFilePath = g_malloc(strlen(expectedOutputDir) + strlen(entry->d_name) + 1);
@@ -45,30 +54,16 @@ void run_unit_tests(char *outputDir, char *expectedOutputDir) {
         }
         /*printf("Reading expected output file %s\n", expectedOutputFilePath);
         printf("Reading output file %s\n", outputFilePath);*/
-        // count the number of lines in the file (so we can allocate the memory for the strings)
-        int lines = 0;
-        char c;
-        while ((c = fgetc(expectedOutputFile)) != EOF) {
-            if (c == '\n') {
-                lines++;
-            }
-        }
-        //printf("Number of lines: %d for file %s\n", lines, expectedOutputFilePath);
-        // now we need to compare the content of the files
-        char **expectedOutput = malloc(lines * sizeof(char *));
-        char **output = malloc(lines * sizeof(char *));
-        for (int i = 0; i < lines; i++) {
-            expectedOutput[i] = malloc(1000);
-            output[i] = malloc(1000);
-        }
-        rewind(expectedOutputFile);
-        rewind(outputFile);
-        int line = 0;
+        // now we need to compare the content of the files (the lines can have any length)
+        LINE_READER *expectedOutputReader = new_line_reader(expectedOutputFile);
+        LINE_READER *outputReader = new_line_reader(outputFile);
+        int line = 0, different = 0;
         // run through the files and compare the lines (independent if the file has lines (is null or not), if it is empty and should have something, it counts as a difference)
         while (1) {
-            char *expectedOutputLine = fgets(expectedOutput[line], 1000, expectedOutputFile);
-            char *outputLine = fgets(output[line], 1000, outputFile);
-            //printf("Expected: %s\nGot: %s\n", expectedOutput[line], output[line]);
+            size_t expectedOutputLength, outputLength;
+            char *expectedOutputLine = read_line(expectedOutputReader, &expectedOutputLength);
+            char *outputLine = read_line(outputReader, &outputLength);
+            //printf("Expected: %s\nGot: %s\n", expectedOutputLine, outputLine);
             if (expectedOutputLine == NULL && outputLine == NULL) {
                 // we reached the end of both files
                 break;
@@ -77,28 +72,34 @@ void run_unit_tests(char *outputDir, char *expectedOutputDir) {
                 // one of the files has less lines than the other
                 printf("Difference in file %s at line %d\n", entry->d_name, line);
                 printf("Expected: %sGot: %s\n\n", expectedOutputLine, outputLine ? outputLine : "(empty line)");
+                different = 1;
                 break; // we can remove this if we want to check all the lines
             }
             // Trim newline character from expectedOutput
-            if (expectedOutput[line][strlen(expectedOutput[line]) - 1] == '\n') {
-                expectedOutput[line][strlen(expectedOutput[line]) - 1] = '\0';
+            if (expectedOutputLength > 0 && expectedOutputLine[expectedOutputLength - 1] == '\n') {
+                expectedOutputLine[expectedOutputLength - 1] = '\0';
             }
             // Trim newline character from output
-            if (output[line][strlen(output[line]) - 1] == '\n') {
-                output[line][strlen(output[line]) - 1] = '\0';
+            if (outputLength > 0 && outputLine[outputLength - 1] == '\n') {
+                outputLine[outputLength - 1] = '\0';
             }
-            if (strcmp(expectedOutput[line], output[line]) != 0) {
+            if (strcmp(expectedOutputLine, outputLine) != 0) {
                 printf("Difference in file %s at line %d\n", entry->d_name, line);
-                printf("Expected: %s\nGot: %s\n\n", expectedOutput[line], output[line]);
+                printf("Expected: %s\nGot: %s\n\n", expectedOutputLine, outputLine);
+                different = 1;
                 //printf("Line %d in %s and line %d in %s\n", line, expectedOutputFilePath, line, outputFilePath);
             }
             line++;
         }
+        failed += different;
+        free_line_reader(expectedOutputReader);
+        free_line_reader(outputReader);
         fclose(expectedOutputFile);
         fclose(outputFile);
         g_free(expectedOutputFilePath);
         g_free(outputFilePath);
     }
     closedir(dir);
-    printf("All unit tests done!\n");
+    printf("All unit tests done! (%d files with differences)\n", failed);
+    return failed;
 }
\ No newline at end of file
@@ -27,15 +27,39 @@ char *toupper_str(const char *str) {
     return str_copy;
 }
 
+// pushed after the last buffer, it tells the writer thread to stop
+static ERROR_BUFFER closing_buffer = { NULL, 0 };
+
+/**
+ * @brief Writes the buffers of an error registery to its file, in the order they were filled, until the registery is closed.
+ *      Each written buffer is given back to the parser to be filled again.
+ * 
+ * @param data The error registery. @see initialize_error_registery
+ * @return gpointer NULL.
+ */
+static gpointer error_registery_writer(gpointer data) {
+    ERROR_REGISTERY *registery = (ERROR_REGISTERY *) data;
+    ERROR_BUFFER *buffer;
+    while ((buffer = g_async_queue_pop(registery->full)) != &closing_buffer) {
+        if (fwrite(buffer->data, 1, buffer->used, registery->file) != buffer->used) {
+            perror("Error writing errors file");
+            exit(EXIT_FAILURE);
+        }
+        buffer->used = 0;
+        g_async_queue_push(registery->empty, buffer);
+    }
+    return NULL;
+}
+
 // lets make it different so old lines dont get deleted
 /**
- * @brief Initializes the error registery (csv file).
+ * @brief Initializes the error registery (csv file). The lines are written by a writer thread, in big buffers.
  * 
  * @param outputDir The output directory to save the results.
  * @param error_dataset The name of the error dataset.
- * @return FILE* 
+ * @return ERROR_REGISTERY* The error registery. @see struct ERROR_REGISTERY
  */
-FILE *initialize_error_registery(const char *outputDir, const char *error_dataset) {
+ERROR_REGISTERY *initialize_error_registery(const char *outputDir, const char *error_dataset) {
     // create a csv file to write errors in outputDir
     char error_dataset_path[MAX_PATH_LENGTH];
     // if outputDir ends in /, remove it
@@ -49,27 +73,98 @@ FILE *initialize_error_registery(const char *outputDir, const char *error_datase
         perror("Error opening file");
         exit(EXIT_FAILURE);
     }
-    return file;
+    ERROR_REGISTERY *registery = g_new(ERROR_REGISTERY, 1);
+    registery->file = file;
+    registery->current = NULL;
+    registery->buffers_count = 0;
+    registery->full = g_async_queue_new();
+    registery->empty = g_async_queue_new();
+    registery->writer = g_thread_new("errors", error_registery_writer, registery);
+    return registery;
+}
+
+/**
+ * @brief Gets a buffer to fill: a new one while there are less than ERROR_REGISTERY_BUFFERS, else the next one written (waits for the writer).
+ * 
+ * @param registery The error registery.
+ * @return ERROR_BUFFER* The empty buffer.
+ */
+static ERROR_BUFFER *next_error_buffer(ERROR_REGISTERY *registery) {
+    if (registery->buffers_count < ERROR_REGISTERY_BUFFERS) {
+        ERROR_BUFFER *buffer = g_new(ERROR_BUFFER, 1);
+        buffer->data = g_malloc(ERROR_REGISTERY_BUFFER_SIZE);
+        buffer->used = 0;
+        registery->buffers_count++;
+        return buffer;
+    }
+    return g_async_queue_pop(registery->empty);
+}
+
+/**
+ * @brief Copies bytes to the buffers of an error registery, sending each buffer that gets full to the writer thread.
+ * 
+ * @param registery The error registery.
+ * @param data The bytes to copy.
+ * @param size The number of bytes.
+ */
+static void append_error_bytes(ERROR_REGISTERY *registery, const char *data, size_t size) {
+    while (size > 0) {
+        if (registery->current == NULL) {
+            registery->current = next_error_buffer(registery);
+        }
+        ERROR_BUFFER *buffer = registery->current;
+        size_t length = ERROR_REGISTERY_BUFFER_SIZE - buffer->used;
+        if (length > size) {
+            length = size;
+        }
+        memcpy(buffer->data + buffer->used, data, length);
+        buffer->used += length;
+        data += length;
+        size -= length;
+        if (buffer->used == ERROR_REGISTERY_BUFFER_SIZE) {
+            g_async_queue_push(registery->full, buffer);
+            registery->current = NULL;
+        }
+    }
 }
 
 /**
  * @brief Registers an error line in the error registery (csv file).
  * 
- * @param file The error registery (csv file).
+ * @param registery The error registery. @see initialize_error_registery
  * @param line The error line to register (line from the input file, its the same line that was read by the interpreter as a command)
  */
-void register_error_line(FILE *file, const char *line) {
+void register_error_line(ERROR_REGISTERY *registery, const char *line) {
     // write a new line on the created csv
-    fprintf(file, "%s\n", line);
+    append_error_bytes(registery, line, strlen(line));
+    append_error_bytes(registery, "\n", 1);
 }
 
 /**
- * @brief Closes the error registery (csv file).
+ * @brief Closes the error registery (csv file): writes the lines still in the buffers, waits for the writer thread and frees the registery.
  * 
- * @param file The error registery (csv file).
+ * @param registery The error registery.
  */
-void close_error_registery(FILE *file) {
-    fclose(file);
+void close_error_registery(ERROR_REGISTERY *registery) {
+    if (registery->current != NULL) {
+        g_async_queue_push(registery->full, registery->current);
+        registery->current = NULL;
+    }
+    g_async_queue_push(registery->full, &closing_buffer);
+    g_thread_join(registery->writer);
+    // every buffer was written, so they are all back in the empty queue
+    for (int i = 0; i < registery->buffers_count; i++) {
+        ERROR_BUFFER *buffer = g_async_queue_pop(registery->empty);
+        g_free(buffer->data);
+        g_free(buffer);
+    }
+    g_async_queue_unref(registery->full);
+    g_async_queue_unref(registery->empty);
+    if (fclose(registery->file) != 0) {
+        perror("Error closing errors file");
+        exit(EXIT_FAILURE);
+    }
+    g_free(registery);
 }
 
 // output_buffer
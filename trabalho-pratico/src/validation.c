@@ -5,6 +5,7 @@
 #include "validation.h"
 #include "structs.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
@@ -17,71 +18,143 @@ O formato deverá ser sempre do tipo nnnn/nn/nn, onde n é um número entre 0 e
 O mês deverá estar entre 1 e 12 (inclusivo) e o dia entre 1 e 31 (inclusivo). Ignorar a validação dos dias consoante o mês (e.g., datas como 2023/02/31 não surgirão). Exemplos
 de erros: 2023/01/52, 2023/14/03, . . .
 */
+/*
+O formato deverá ser sempre do tipo nnnn/nn/nn nn:nn:nn, onde n é um número entre
+0 e 9 (inclusivo);
+– As mesmas regras das datas aplicam-se aqui;
+– A hora deverá estar entre 0 e 23 (inclusivo), os minutos entre 0 e 59 (inclusivo), e os
+segundos entre 0 e 59 (inclusivo). Exemplos de erro: 2023/10/01 32:23:05, 2023/10/01
+12:95:05, 2023/10/01 12:23:75, . . . ;
+*/
 /**
- * @brief Validates a date.
+ * @brief Converts two digits to a number (or -1 if they are not digits).
+ *      The second character is only read if the first one is a digit, so it never reads after the end of the string.
  * 
- * @param date The date to validate.
- * @return int 1 if the date is valid, 0 otherwise.
+ * @param s The two digits.
+ * @return int The number or -1.
  */
-int validateDate(char *date) {
-    // check if the date is valid
-    // lets start by checking if they have hours associated, then execute "validateDateWithTime" else they are just dates "validateDateWithoutTime"
-    if (strchr(date, ' ') != NULL) {
-        return validateDateWithTime(date);
-    } else {
-        return validateDateWithoutTime(date);
+static inline int two_digits(const char *s) {
+    unsigned int d1 = (unsigned char) s[0] - '0';
+    if (d1 > 9) {
+        return -1;
     }
-    return 0;
+    unsigned int d2 = (unsigned char) s[1] - '0';
+    if (d2 > 9) {
+        return -1;
+    }
+    return d1 * 10 + d2;
 }
 
 /**
- * @brief Validates a date without time.
+ * @brief Parses a date (nnnn/nn/nn) or a date with time (nnnn/nn/nn nn:nn:nn) in a single pass, without allocating.
+ *      The date is saved as a packed integer, that keeps the chronological order. @see DATETIME
  * 
- * @param date The date to validate.
- * @return int 1 if the date is valid, 0 otherwise.
+ * @param date The date to parse.
+ * @param parsed Where the packed date is saved (can be NULL, it is set to 0 if the date is invalid).
+ * @param strict 1 if the date must end after the day or the seconds, 0 to ignore what comes after the date (like sscanf).
+ * @return int DATE_ONLY or DATE_TIME if the date is valid, DATE_INVALID otherwise.
  */
-int validateDateWithoutTime(char *date) {
-    char *date_copy = g_strdup(date); // Create a mutable copy of the input string
-    if (date_copy == NULL) {
-        return 0; // Handle memory allocation error
+static int parse_date(const char *date, DATETIME *parsed, int strict) {
+    if (parsed != NULL) {
+        *parsed = 0;
+    }
+    if (date == NULL) {
+        return DATE_INVALID;
+    }
+    // each character is only read if the previous ones are valid (two_digits returns -1 for non digits, including the '\0')
+    int century = two_digits(date);
+    int year = century < 0 ? -1 : two_digits(date + 2);
+    if (year < 0 || date[4] != '/') {
+        return DATE_INVALID;
+    }
+    int month = two_digits(date + 5);
+    if (month < 1 || month > 12 || date[7] != '/') {
+        return DATE_INVALID;
+    }
+    int day = two_digits(date + 8);
+    year += century * 100;
+    if (day < 1 || day > 31 || year == 0) {
+        return DATE_INVALID;
+    }
+    DATETIME value = MAKE_DATETIME(year, month, day, 0, 0, 0);
+    int type = DATE_ONLY;
+    if (date[10] == ' ') {
+        int hour = two_digits(date + 11);
+        int minute = hour < 0 || hour > 23 || date[13] != ':' ? -1 : two_digits(date + 14);
+        int second = minute < 0 || minute > 59 || date[16] != ':' ? -1 : two_digits(date + 17);
+        if (second >= 0 && second <= 59 && (!strict || date[19] == '\0')) {
+            value |= MAKE_DATETIME(0, 0, 0, hour, minute, second);
+            type = DATE_TIME;
+        } else if (strict) {
+            return DATE_INVALID;
+        }
+    } else if (strict && date[10] != '\0') {
+        return DATE_INVALID;
     }
-
-    char *year = strtok(date_copy, "/");
-    char *month = strtok(NULL, "/");
-    char *day = strtok(NULL, "/");
-    
-    if (year == NULL || month == NULL || day == NULL) {
-        g_free(date_copy);
-        return 0; // Handle bad date format
+    if (parsed != NULL) {
+        *parsed = value;
     }
+    return type;
+}
 
-    if (strlen(year) != 4 || strlen(month) != 2 || strlen(day) != 2) {
-        g_free(date_copy);
-        return 0; // Handle the case where the tokens don't have the right length
-    }
+/**
+ * @brief Parses and validates a date (nnnn/nn/nn) or a date with time (nnnn/nn/nn nn:nn:nn) in a single pass, without allocating.
+ *      The date is saved as a packed integer, that keeps the chronological order. @see DATETIME
+ * 
+ * @param date The date to parse.
+ * @param parsed Where the packed date is saved (can be NULL, it is set to 0 if the date is invalid).
+ * @return int DATE_ONLY or DATE_TIME if the date is valid, DATE_INVALID otherwise.
+ */
+int parseDate(const char *date, DATETIME *parsed) {
+    return parse_date(date, parsed, 1);
+}
 
-    int year_int = atoi(year);
-    int month_int = atoi(month);
-    int day_int = atoi(day);
+/**
+ * @brief Parses the date (and time) at the start of a string, ignoring what comes after it (e.g. the rest of a result line).
+ * 
+ * @param date The string that starts with the date.
+ * @param parsed Where the packed date is saved (can be NULL, it is set to 0 if there is no valid date).
+ * @return int DATE_ONLY or DATE_TIME if the string starts with a valid date, DATE_INVALID otherwise.
+ */
+int scanDate(const char *date, DATETIME *parsed) {
+    return parse_date(date, parsed, 0);
+}
 
-    if (year_int == 0 || month_int < 1 || month_int > 12 || day_int < 1 || day_int > 31) {
-        g_free(date_copy);
-        return 0; // Handle out-of-range values
+/**
+ * @brief Formats a packed date as a date (nnnn/nn/nn) or a date with time (nnnn/nn/nn nn:nn:nn), the inverse of parseDate.
+ * 
+ * @param date The packed date. @see parseDate
+ * @param type DATE_ONLY to format only the date, DATE_TIME to format the date with time.
+ * @param buffer Where the date is saved (must have space for DATE_STRING_SIZE characters).
+ */
+void formatDate(DATETIME date, int type, char *buffer) {
+    if (type == DATE_TIME) {
+        snprintf(buffer, DATE_STRING_SIZE, "%04d/%02d/%02d %02d:%02d:%02d", DATETIME_YEAR(date), DATETIME_MONTH(date), DATETIME_DAY(date), DATETIME_HOUR(date), DATETIME_MINUTE(date), DATETIME_SECOND(date));
+    } else {
+        snprintf(buffer, DATE_STRING_SIZE, "%04d/%02d/%02d", DATETIME_YEAR(date), DATETIME_MONTH(date), DATETIME_DAY(date));
     }
+}
 
-    g_free(date_copy);
+/**
+ * @brief Validates a date (with or without time).
+ * 
+ * @param date The date to validate.
+ * @return int 1 if the date is valid, 0 otherwise.
+ */
+int validateDate(char *date) {
+    return parseDate(date, NULL) != DATE_INVALID;
+}
 
-    return 1;
+/**
+ * @brief Validates a date without time.
+ * 
+ * @param date The date to validate.
+ * @return int 1 if the date is valid, 0 otherwise.
+ */
+int validateDateWithoutTime(char *date) {
+    return parseDate(date, NULL) == DATE_ONLY;
 }
 
-/*
-O formato deverá ser sempre do tipo nnnn/nn/nn nn:nn:nn, onde n é um número entre
-0 e 9 (inclusivo);
-– As mesmas regras das datas aplicam-se aqui;
-– A hora deverá estar entre 0 e 23 (inclusivo), os minutos entre 0 e 59 (inclusivo), e os
-segundos entre 0 e 59 (inclusivo). Exemplos de erro: 2023/10/01 32:23:05, 2023/10/01
-12:95:05, 2023/10/01 12:23:75, . . . ;
-*/
 /**
  * @brief Validates a date with time.
  * 
@@ -89,43 +162,7 @@ segundos entre 0 e 59 (inclusivo). Exemplos de erro: 2023/10/01 32:23:05, 2023/1
  * @return int 1 if the date is valid, 0 otherwise.
  */
 int validateDateWithTime(char* date) {
-    char *date_copy = g_strdup(date); // Create a mutable copy of the input string
-    if (date_copy == NULL) {
-        return 0; // Handle memory allocation error
-    }
-
-    char *year = strtok(date_copy, "/");
-    char *month = strtok(NULL, "/");
-    char *day = strtok(NULL, " ");
-    char *hour = strtok(NULL, ":");
-    char *minute = strtok(NULL, ":");
-    char *second = strtok(NULL, ":");
-
-    if (year == NULL || month == NULL || day == NULL || hour == NULL || minute == NULL || second == NULL) {
-        g_free(date_copy);
-        return 0; // Handle bad date format
-    }
-
-    if (strlen(year) != 4 || strlen(month) != 2 || strlen(day) != 2 || strlen(hour) != 2 || strlen(minute) != 2 || strlen(second) != 2) {
-        g_free(date_copy);
-        return 0; // Handle the case where the tokens don't have the right length
-    }
-
-    int year_int = atoi(year);
-    int month_int = atoi(month);
-    int day_int = atoi(day);
-    int hour_int = atoi(hour);
-    int minute_int = atoi(minute);
-    int second_int = atoi(second);
-
-    if (year_int == 0 || month_int < 1 || month_int > 12 || day_int < 1 || day_int > 31 || hour_int < 0 || hour_int > 23 || minute_int < 0 || minute_int > 59 || second_int < 0 || second_int > 59) {
-        g_free(date_copy);
-        return 0; // Handle out-of-range values
-    }
-
-    g_free(date_copy);
-
-    return 1;
+    return parseDate(date, NULL) == DATE_TIME;
 }
 
 /*
@@ -134,89 +171,74 @@ tem que vir antes de schedule_arrival_date, e o real_departure_date tem que vir
 real_arrival_date; E nas reservas, o begin_date tem que vir antes do end_date;
 */
 /**
- * @brief Compares two dates.
+ * @brief Compares two parsed dates. If any of them has no time, only the dates are compared.
  * 
- * @param d1 The first date.
+ * @param d1 The first date. @see parseDate
+ * @param type1 The type of the first date (DATE_ONLY or DATE_TIME).
  * @param d2 The second date.
- * @return int 1 if d1 happens first than d2, -1 if d2 happens first than d1, 0 if they are the same.
+ * @param type2 The type of the second date (DATE_ONLY or DATE_TIME).
+ * @return int 1 if d1 happens first than d2, -1 if d2 happens first than d1 (or a date is invalid), 0 if they are the same.
  */
-int compareDates(char* d1, char* d2) {
-    // returns success if d1 happens first than d2
-    // returns error if d2 happens first than d1
-    // lets first check if the date is valid (prevent segmentation fault)
-    if (validateDate(d1) == 0 || validateDate(d2) == 0) {
+int compareParsedDates(DATETIME d1, int type1, DATETIME d2, int type2) {
+    if (type1 == DATE_INVALID || type2 == DATE_INVALID) {
         return -1;
     }
-    // lets start by checking if they have hours associated, then execute "compareDatesWithTime" else they are just dates "compareDatesWithoutTime"
-    if (strchr(d1, ' ') != NULL && strchr(d2, ' ') != NULL) {
-        return compareDatesWithTime(d1, d2);
-    } else {
-        return compareDatesWithoutTime(d1, d2);
+    if (type1 != DATE_TIME || type2 != DATE_TIME) {
+        d1 = DATETIME_DATE(d1);
+        d2 = DATETIME_DATE(d2);
     }
-    return 0;
+    return (d1 < d2) - (d1 > d2);
 }
 
 /**
- * @brief Compares two dates without time.
+ * @brief Parses two dates (that must be in order, e.g. begin and end dates) and compares them. @see compareParsedDates
+ *      Used by the validation chains of the parsers, so each date is only parsed once.
  * 
  * @param d1 The first date.
  * @param d2 The second date.
- * @return int 1 if d1 happens first than d2, -1 if d2 happens first than d1, 0 if they are the same.
+ * @param parsed1 Where the first packed date is saved (can be NULL).
+ * @param parsed2 Where the second packed date is saved (can be NULL).
+ * @return int 1 if d1 happens first than d2, -1 if d2 happens first than d1 (or a date is invalid), 0 if they are the same.
  */
-int compareDatesWithoutTime(char* d1, char* d2) {
-    // returns success if d1 happens first than d2
-    // returns error if d2 happens first than d1
-    char *d1_copy = g_strdup(d1); // Create a mutable copy of the input string
-    char *d2_copy = g_strdup(d2); // Create a mutable copy of the input string
-    if (d1_copy == NULL || d2_copy == NULL) {
-        return -1; // Handle memory allocation error
+int parseDateRange(const char *d1, const char *d2, DATETIME *parsed1, DATETIME *parsed2) {
+    DATETIME p1, p2;
+    int type1 = parseDate(d1, &p1);
+    int type2 = parseDate(d2, &p2);
+    if (parsed1 != NULL) {
+        *parsed1 = p1;
     }
-
-    char *d1_year = strtok(d1_copy, "/");
-    char *d1_month = strtok(NULL, "/");
-    char *d1_day = strtok(NULL, "/");
-    
-    char *d2_year = strtok(d2_copy, "/");
-    char *d2_month = strtok(NULL, "/");
-    char *d2_day = strtok(NULL, "/");
-    
-    if (d1_year == NULL || d1_month == NULL || d1_day == NULL || d2_year == NULL || d2_month == NULL || d2_day == NULL) {
-        g_free(d1_copy);
-        g_free(d2_copy);
-        return -1; // Handle bad date format
+    if (parsed2 != NULL) {
+        *parsed2 = p2;
     }
+    return compareParsedDates(p1, type1, p2, type2);
+}
 
-    int d1_year_int = atoi(d1_year);
-    int d1_month_int = atoi(d1_month);
-    int d1_day_int = atoi(d1_day);
-
-    int d2_year_int = atoi(d2_year);
-    int d2_month_int = atoi(d2_month);
-    int d2_day_int = atoi(d2_day);
-
-    g_free(d1_copy);
-    g_free(d2_copy);
+/**
+ * @brief Compares two dates.
+ * 
+ * @param d1 The first date.
+ * @param d2 The second date.
+ * @return int 1 if d1 happens first than d2, -1 if d2 happens first than d1, 0 if they are the same.
+ */
+int compareDates(char* d1, char* d2) {
+    // returns success if d1 happens first than d2
+    // returns error if d2 happens first than d1 (or if a date is invalid)
+    return parseDateRange(d1, d2, NULL, NULL);
+}
 
-    if (d1_year_int < d2_year_int) {
-        return 1;
-    } else if (d1_year_int > d2_year_int) {
+/**
+ * @brief Compares two dates without time (if they have time, it is ignored).
+ * 
+ * @param d1 The first date.
+ * @param d2 The second date.
+ * @return int 1 if d1 happens first than d2, -1 if d2 happens first than d1, 0 if they are the same.
+ */
+int compareDatesWithoutTime(char* d1, char* d2) {
+    DATETIME p1, p2;
+    if (parseDate(d1, &p1) == DATE_INVALID || parseDate(d2, &p2) == DATE_INVALID) {
         return -1;
-    } else {
-        if (d1_month_int < d2_month_int) {
-            return 1;
-        } else if (d1_month_int > d2_month_int) {
-            return -1;
-        } else {
-            if (d1_day_int < d2_day_int) {
-                return 1;
-            } else if (d1_day_int > d2_day_int) {
-                return -1;
-            } else {
-                return 0;
-            }
-        }
     }
-    return 0;
+    return compareParsedDates(p1, DATE_ONLY, p2, DATE_ONLY);
 }
 
 /**
@@ -227,87 +249,11 @@ int compareDatesWithoutTime(char* d1, char* d2) {
  * @return int 1 if d1 happens first than d2, -1 if d2 happens first than d1, 0 if they are the same.
  */
 int compareDatesWithTime(char* d1, char* d2) {
-    char *d1_copy = g_strdup(d1); // Create a mutable copy of the input string
-    char *d2_copy = g_strdup(d2); // Create a mutable copy of the input string
-    if (d1_copy == NULL || d2_copy == NULL) {
-        return -1; // Handle memory allocation error
-    }
-
-    char *d1_year = strtok(d1_copy, "/");
-    char *d1_month = strtok(NULL, "/");
-    char *d1_day = strtok(NULL, " ");
-    char *d1_hour = strtok(NULL, ":");
-    char *d1_minute = strtok(NULL, ":");
-    char *d1_second = strtok(NULL, ":");
-
-    char *d2_year = strtok(d2_copy, "/");
-    char *d2_month = strtok(NULL, "/");
-    char *d2_day = strtok(NULL, " ");
-    char *d2_hour = strtok(NULL, ":");
-    char *d2_minute = strtok(NULL, ":");
-    char *d2_second = strtok(NULL, ":");
-
-    if (d1_year == NULL || d1_month == NULL || d1_day == NULL || d1_hour == NULL || d1_minute == NULL || d1_second == NULL || d2_year == NULL || d2_month == NULL || d2_day == NULL || d2_hour == NULL || d2_minute == NULL || d2_second == NULL) {
-        g_free(d1_copy);
-        g_free(d2_copy);
-        return -1; // Handle bad date format
-    }
-
-    int d1_year_int = atoi(d1_year);
-    int d1_month_int = atoi(d1_month);
-    int d1_day_int = atoi(d1_day);
-    int d1_hour_int = atoi(d1_hour);
-    int d1_minute_int = atoi(d1_minute);
-    int d1_second_int = atoi(d1_second);
-
-    int d2_year_int = atoi(d2_year);
-    int d2_month_int = atoi(d2_month);
-    int d2_day_int = atoi(d2_day);
-    int d2_hour_int = atoi(d2_hour);
-    int d2_minute_int = atoi(d2_minute);
-    int d2_second_int = atoi(d2_second);
-
-    g_free(d1_copy);
-    g_free(d2_copy);
-
-    if (d1_year_int < d2_year_int) {
-        return 1;
-    } else if (d1_year_int > d2_year_int) {
+    DATETIME p1, p2;
+    if (parseDate(d1, &p1) != DATE_TIME || parseDate(d2, &p2) != DATE_TIME) {
         return -1;
-    } else {
-        if (d1_month_int < d2_month_int) {
-            return 1;
-        } else if (d1_month_int > d2_month_int) {
-            return -1;
-        } else {
-            if (d1_day_int < d2_day_int) {
-                return 1;
-            } else if (d1_day_int > d2_day_int) {
-                return -1;
-            } else {
-                if (d1_hour_int < d2_hour_int) {
-                    return 1;
-                } else if (d1_hour_int > d2_hour_int) {
-                    return -1;
-                } else {
-                    if (d1_minute_int < d2_minute_int) {
-                        return 1;
-                    } else if (d1_minute_int > d2_minute_int) {
-                        return -1;
-                    } else {
-                        if (d1_second_int < d2_second_int) {
-                            return 1;
-                        } else if (d1_second_int > d2_second_int) {
-                            return -1;
-                        } else {
-                            return 0;
-                        }
-                    }
-                }
-            }
-        }
     }
-    return 0;
+    return compareParsedDates(p1, DATE_TIME, p2, DATE_TIME);
 }
 
 /*
@@ -326,13 +272,14 @@ int validateEmail(char *email) {
         return 0;
     } else {
         char *email_copy = g_strdup(email); // Create a mutable copy of the input string
+        char *saveptr; // strtok_r state (strtok is not safe when the parsers run in parallel)
         if (email_copy == NULL) {
             return 0; // Handle memory allocation error
         }
 
-        char *username = strtok(email_copy, "@");
-        char *domain = strtok(NULL, ".");
-        char *tld = strtok(NULL, ".");
+        char *username = strtok_r(email_copy, "@", &saveptr);
+        char *domain = strtok_r(NULL, ".", &saveptr);
+        char *tld = strtok_r(NULL, ".", &saveptr);
 
         if (username == NULL || domain == NULL || tld == NULL) {
             g_free(email_copy);
@@ -371,30 +318,36 @@ int validateCCode(char* country_code) {
 O account_status de um utilizador deverá ter o valor “active” ou “inactive”, sendo que diferentes combinações de maiúsculas e minúsculas também são válidas (e.g., “Active”, “aCtive”,
 e “INACTIVE” também são válidos);*/
 /**
- * @brief Validates an account status.
+ * @brief Parses and validates an account status (the case is ignored), without allocating.
  * 
- * @param account_status The account status to validate.
+ * @param account_status The account status to parse.
+ * @param status Where the account status is saved (can be NULL).
  * @return int 1 if the account status is valid, 0 otherwise.
  */
-int isActive(char* account_status) {
-    // first lets convert the string to lowercase
-    char *account_status_copy = g_strdup(account_status); // Create a mutable copy of the input string
-    if (account_status_copy == NULL) {
-        return 0; // Handle memory allocation error
-    }
-
-    for (int i = 0; account_status_copy[i]; i++) {
-        account_status_copy[i] = tolower(account_status_copy[i]);
-    }
-
-    if (strcmp(account_status_copy, "active") == 0) {
-        g_free(account_status_copy);
-        return 1;
+int parseStatus(const char *account_status, ACCOUNT_STATUS *status) {
+    ACCOUNT_STATUS value;
+    if (g_ascii_strcasecmp(account_status, "active") == 0) {
+        value = ACCOUNT_ACTIVE;
+    } else if (g_ascii_strcasecmp(account_status, "inactive") == 0) {
+        value = ACCOUNT_INACTIVE;
     } else {
-        g_free(account_status_copy);
         return 0;
     }
-    return 0;
+    if (status != NULL) {
+        *status = value;
+    }
+    return 1;
+}
+
+/**
+ * @brief Checks if an account status is active.
+ * 
+ * @param account_status The account status to check.
+ * @return int 1 if the account status is active, 0 otherwise.
+ */
+int isActive(char* account_status) {
+    ACCOUNT_STATUS status;
+    return parseStatus(account_status, &status) == 1 && status == ACCOUNT_ACTIVE;
 }
 
 /**
@@ -404,24 +357,7 @@ int isActive(char* account_status) {
  * @return int 1 if the account status is valid, 0 otherwise.
  */
 int validateStatus(char* account_status) {
-    // first lets convert the string to lowercase
-    char *account_status_copy = g_strdup(account_status); // Create a mutable copy of the input string
-    if (account_status_copy == NULL) {
-        return 0; // Handle memory allocation error
-    }
-
-    for (int i = 0; account_status_copy[i]; i++) {
-        account_status_copy[i] = tolower(account_status_copy[i]);
-    }
-
-    if (strcmp(account_status_copy, "active") == 0 || strcmp(account_status_copy, "inactive") == 0) {
-        g_free(account_status_copy);
-        return 1;
-    } else {
-        g_free(account_status_copy);
-        return 0;
-    }
-    return 0;
+    return parseStatus(account_status, NULL);
 }
 
 /*
@@ -605,33 +541,35 @@ O campo includes_breafast de uma reserva pode ser especificado das seguintes for
 diferentes combinações de maiúsculas e minúsculas): Para valores falsos, “f ”, “false”, “0”, e
 “” (string vazia); Para valores verdadeiros, “t”, “true”, e “1”.*/
 /**
- * @brief Validates the breakfast.
+ * @brief Parses and validates the breakfast (the case is ignored), without allocating.
  * 
- * @param includes_breakfast The breakfast.
+ * @param includes_breakfast The breakfast to parse.
+ * @param breakfast Where the breakfast is saved (can be NULL).
  * @return int 1 if the breakfast is valid, 0 otherwise.
  */
-int validateBreakfast(char* includes_breakfast) {
-    // first lets convert the string to lowercase
-    char *includes_breakfast_copy = g_strdup(includes_breakfast); // Create a mutable copy of the input string
-    if (includes_breakfast_copy == NULL) {
-        return 0; // Handle memory allocation error
-    }
-
-    for (int i = 0; includes_breakfast_copy[i]; i++) {
-        includes_breakfast_copy[i] = tolower(includes_breakfast_copy[i]);
-    }
-
-    if (strcmp(includes_breakfast_copy, "f") == 0 || strcmp(includes_breakfast_copy, "false") == 0 || strcmp(includes_breakfast_copy, "0") == 0 || strcmp(includes_breakfast_copy, "") == 0) {
-        g_free(includes_breakfast_copy);
-        return 1;
-    } else if (strcmp(includes_breakfast_copy, "t") == 0 || strcmp(includes_breakfast_copy, "true") == 0 || strcmp(includes_breakfast_copy, "1") == 0) {
-        g_free(includes_breakfast_copy);
-        return 1;
+int parseBreakfast(const char *includes_breakfast, BREAKFAST *breakfast) {
+    BREAKFAST value;
+    if (g_ascii_strcasecmp(includes_breakfast, "f") == 0 || g_ascii_strcasecmp(includes_breakfast, "false") == 0 || strcmp(includes_breakfast, "0") == 0 || includes_breakfast[0] == '\0') {
+        value = BREAKFAST_NOT_INCLUDED;
+    } else if (g_ascii_strcasecmp(includes_breakfast, "t") == 0 || g_ascii_strcasecmp(includes_breakfast, "true") == 0 || strcmp(includes_breakfast, "1") == 0) {
+        value = BREAKFAST_INCLUDED;
     } else {
-        g_free(includes_breakfast_copy);
         return 0;
     }
-    return 0;
+    if (breakfast != NULL) {
+        *breakfast = value;
+    }
+    return 1;
+}
+
+/**
+ * @brief Validates the breakfast.
+ * 
+ * @param includes_breakfast The breakfast.
+ * @return int 1 if the breakfast is valid, 0 otherwise.
+ */
+int validateBreakfast(char* includes_breakfast) {
+    return parseBreakfast(includes_breakfast, NULL);
 }
 
 /*